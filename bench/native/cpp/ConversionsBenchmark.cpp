@@ -0,0 +1,72 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "units/angle.h"
+#include "units/angular_velocity.h"
+#include "units/length.h"
+#include "units/velocity.h"
+
+#include "MockControllers.h"
+
+// Each iteration commands the adapter and reads it back, which is what a
+// drive does with a module every loop.
+
+namespace {
+
+const rmb::AngularVelocityController::ConversionUnit_t kConversion =
+    4_in / 1_rad;
+
+void BM_AngularAsLinearVelocity(benchmark::State &state) {
+  std::unique_ptr<rmb::LinearVelocityController> controller = rmb::asLinear(
+      std::make_unique<rmb::MockAngularVelocityController>(), kConversion);
+  units::meters_per_second_t velocity = 1.5_mps;
+  for (auto _ : state) {
+    controller->setVelocity(velocity);
+    benchmark::DoNotOptimize(controller->getVelocity());
+    benchmark::DoNotOptimize(controller->getPosition());
+    velocity = -velocity;
+  }
+}
+BENCHMARK(BM_AngularAsLinearVelocity);
+
+void BM_AngularAsLinearPosition(benchmark::State &state) {
+  std::unique_ptr<rmb::LinearPositionController> controller = rmb::asLinear(
+      std::make_unique<rmb::MockAngularPositionController>(), kConversion);
+  units::meter_t position = 0.5_m;
+  for (auto _ : state) {
+    controller->setPosition(position);
+    benchmark::DoNotOptimize(controller->getPosition());
+    benchmark::DoNotOptimize(controller->getVelocity());
+    position = -position;
+  }
+}
+BENCHMARK(BM_AngularAsLinearPosition);
+
+void BM_LinearAsAngularVelocity(benchmark::State &state) {
+  std::unique_ptr<rmb::AngularVelocityController> controller = rmb::asAngular(
+      std::make_unique<rmb::MockLinearVelocityController>(), kConversion);
+  units::radians_per_second_t velocity = 3.0_rad_per_s;
+  for (auto _ : state) {
+    controller->setVelocity(velocity);
+    benchmark::DoNotOptimize(controller->getVelocity());
+    benchmark::DoNotOptimize(controller->getPosition());
+    velocity = -velocity;
+  }
+}
+BENCHMARK(BM_LinearAsAngularVelocity);
+
+void BM_LinearAsAngularPosition(benchmark::State &state) {
+  std::unique_ptr<rmb::AngularPositionController> controller = rmb::asAngular(
+      std::make_unique<rmb::MockLinearPositionController>(), kConversion);
+  units::radian_t position = 1.0_rad;
+  for (auto _ : state) {
+    controller->setPosition(position);
+    benchmark::DoNotOptimize(controller->getPosition());
+    benchmark::DoNotOptimize(controller->getVelocity());
+    position = -position;
+  }
+}
+BENCHMARK(BM_LinearAsAngularPosition);
+
+} // namespace
@@ -0,0 +1,102 @@
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "units/angle.h"
+#include "units/length.h"
+#include "units/voltage.h"
+
+#include "rmb/motorcontrol/feedforward/ArmFeedforward.h"
+#include "rmb/motorcontrol/feedforward/ElevatorFeedforward.h"
+#include "rmb/motorcontrol/feedforward/Feedforward.h"
+#include "rmb/motorcontrol/feedforward/SimpleFeedforward.h"
+
+// Feedforwards are called through a `Feedforward` pointer by the motor
+// controllers, so they are benchmarked the same way.
+
+namespace {
+
+constexpr size_t kInputs = 64;
+
+std::unique_ptr<rmb::Feedforward<units::meters>> makeSimpleFeedforward() {
+  using Feedforward = rmb::SimpleFeedforward<units::meters>;
+  return std::make_unique<Feedforward>(
+      Feedforward::Ks_t(0.2), Feedforward::Kv_t(2.5), Feedforward::Ka_t(0.3));
+}
+
+std::unique_ptr<rmb::Feedforward<units::radians>> makeArmFeedforward() {
+  using Feedforward = rmb::ArmFeedforward;
+  return std::make_unique<Feedforward>(
+      Feedforward::Ks_t(0.2), Feedforward::Ks_t(0.8), Feedforward::Kv_t(1.2),
+      Feedforward::Ka_t(0.1));
+}
+
+std::unique_ptr<rmb::Feedforward<units::meters>> makeElevatorFeedforward() {
+  using Feedforward = rmb::ElevatorFeedforward<units::meters>;
+  return std::make_unique<Feedforward>(
+      Feedforward::Ks_t(0.2), Feedforward::Ks_t(0.6), Feedforward::Kv_t(3.0),
+      Feedforward::Ka_t(0.2));
+}
+
+/**
+ * Velocities, positions and accelerations covering both directions of
+ * travel, so the sign of the static gain changes between calls.
+ */
+template <typename DistanceUnit> struct FeedforwardInputs {
+  using Feedforward = rmb::Feedforward<DistanceUnit>;
+
+  std::array<typename Feedforward::Velocity_t, kInputs> velocities;
+  std::array<typename Feedforward::Distance_t, kInputs> positions;
+  std::array<typename Feedforward::Acceleration_t, kInputs> accelerations;
+
+  FeedforwardInputs() {
+    for (size_t i = 0; i < kInputs; i++) {
+      double t = static_cast<double>(i) / kInputs;
+      velocities[i] = typename Feedforward::Velocity_t(4.0 * t - 2.0);
+      positions[i] = typename Feedforward::Distance_t(3.0 * t - 1.5);
+      accelerations[i] = typename Feedforward::Acceleration_t(1.0 - 2.0 * t);
+    }
+  }
+};
+
+template <typename DistanceUnit,
+          std::unique_ptr<rmb::Feedforward<DistanceUnit>> (*Make)()>
+void BM_FeedforwardCalculate(benchmark::State &state) {
+  std::unique_ptr<rmb::Feedforward<DistanceUnit>> feedforward = Make();
+  FeedforwardInputs<DistanceUnit> inputs;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(feedforward->calculate(
+        inputs.velocities[i], inputs.positions[i], inputs.accelerations[i]));
+    i = (i + 1) % kInputs;
+  }
+}
+BENCHMARK_TEMPLATE(BM_FeedforwardCalculate, units::meters,
+                   makeSimpleFeedforward);
+BENCHMARK_TEMPLATE(BM_FeedforwardCalculate, units::radians,
+                   makeArmFeedforward);
+BENCHMARK_TEMPLATE(BM_FeedforwardCalculate, units::meters,
+                   makeElevatorFeedforward);
+
+template <typename DistanceUnit,
+          std::unique_ptr<rmb::Feedforward<DistanceUnit>> (*Make)()>
+void BM_FeedforwardMaxAchievableVelocity(benchmark::State &state) {
+  std::unique_ptr<rmb::Feedforward<DistanceUnit>> feedforward = Make();
+  FeedforwardInputs<DistanceUnit> inputs;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(feedforward->maxAchievableVelocity(
+        12_V, inputs.accelerations[i], inputs.positions[i]));
+    i = (i + 1) % kInputs;
+  }
+}
+BENCHMARK_TEMPLATE(BM_FeedforwardMaxAchievableVelocity, units::meters,
+                   makeSimpleFeedforward);
+BENCHMARK_TEMPLATE(BM_FeedforwardMaxAchievableVelocity, units::radians,
+                   makeArmFeedforward);
+BENCHMARK_TEMPLATE(BM_FeedforwardMaxAchievableVelocity, units::meters,
+                   makeElevatorFeedforward);
+
+} // namespace
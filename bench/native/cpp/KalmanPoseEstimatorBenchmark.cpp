@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Rotation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+
+#include "units/acceleration.h"
+#include "units/angle.h"
+#include "units/angular_velocity.h"
+#include "units/length.h"
+#include "units/math.h"
+#include "units/time.h"
+#include "units/velocity.h"
+
+#include "rmb/drive/KalmanPoseEstimator.h"
+
+// Every benchmark starts with the odometry history full, so each call does
+// the most work it ever will. Run with --benchmark_repetitions to also get
+// the slowest repetition.
+
+namespace {
+
+constexpr units::second_t kPeriod = 5_ms; /* <- Odometry thread period. */
+
+/**
+ * Estimator driven around a circle at 2 m/s with its odometry history full.
+ */
+class CirclingEstimator {
+public:
+  CirclingEstimator()
+      : estimator(rmb::KalmanPoseEstimatorHelper::NoiseConfig{},
+                  frc::Rotation2d(), frc::Pose2d(), 0_s) {
+    for (size_t i = 0; i < 512; i++) {
+      update();
+    }
+  }
+
+  void update() {
+    time += kPeriod;
+    heading = heading + frc::Rotation2d(kOmega * kPeriod);
+    estimator.update(time, heading, {kSpeed, 0_mps, kOmega}, 0_mps_sq,
+                     kSpeed * kOmega / 1_rad);
+  }
+
+  /** Where the robot was `latency` ago, as a camera would have seen it. */
+  frc::Pose2d visionPose(units::second_t latency) const {
+    units::radian_t angle = kOmega * (time - latency);
+    units::meter_t radius = kSpeed / kOmega * 1_rad;
+    return frc::Pose2d(radius * units::math::sin(angle),
+                       radius * (1.0 - units::math::cos(angle)),
+                       frc::Rotation2d(angle));
+  }
+
+  units::second_t time = 0_s;
+  frc::Rotation2d heading;
+  rmb::KalmanPoseEstimator estimator;
+
+private:
+  static constexpr units::meters_per_second_t kSpeed = 2_mps;
+  static constexpr units::radians_per_second_t kOmega = 1_rad_per_s;
+};
+
+double maxStatistic(const std::vector<double> &values) {
+  return *std::max_element(values.begin(), values.end());
+}
+
+void BM_KalmanPoseEstimatorUpdate(benchmark::State &state) {
+  CirclingEstimator circling;
+  for (auto _ : state) {
+    circling.update();
+  }
+}
+BENCHMARK(BM_KalmanPoseEstimatorUpdate)->ComputeStatistics("max", maxStatistic);
+
+/**
+ * Applies a measurement captured `state.range(0)` milliseconds ago. Older
+ * measurements search further back through the history.
+ */
+void BM_KalmanPoseEstimatorVision(benchmark::State &state) {
+  CirclingEstimator circling;
+  units::second_t latency = units::millisecond_t(state.range(0));
+  frc::Pose2d pose = circling.visionPose(latency);
+  bool applied = true;
+  for (auto _ : state) {
+    applied &= circling.estimator.addVisionMeasurement(
+        pose, circling.time - latency, {0.5, 0.5, 0.5});
+  }
+
+  if (!applied) {
+    state.SkipWithError("Measurement was older than the history.");
+  }
+}
+BENCHMARK(BM_KalmanPoseEstimatorVision)
+    ->ArgName("latencyMs")
+    ->Arg(20)
+    ->Arg(250)
+    ->Arg(1200)
+    ->ComputeStatistics("max", maxStatistic);
+
+/**
+ * One robot loop at 50 Hz: four odometry updates and a measurement from
+ * each of two cameras.
+ */
+void BM_KalmanPoseEstimatorLoop(benchmark::State &state) {
+  CirclingEstimator circling;
+  for (auto _ : state) {
+    for (size_t i = 0; i < 4; i++) {
+      circling.update();
+    }
+    for (size_t i = 0; i < 2; i++) {
+      circling.estimator.addVisionMeasurement(circling.visionPose(60_ms),
+                                              circling.time - 60_ms);
+    }
+  }
+}
+BENCHMARK(BM_KalmanPoseEstimatorLoop)->ComputeStatistics("max", maxStatistic);
+
+} // namespace
@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <frc/simulation/GenericHIDSim.h>
+
+#include "rmb/controller/LogitechGamepad.h"
+
+namespace {
+
+constexpr int kPort = 0;
+
+/**
+ * Publishes a fixed reading on every axis through the simulated driver
+ * station. One stick sits inside the dead zone so both branches are taken.
+ */
+void setAxes() {
+  frc::sim::GenericHIDSim sim(kPort);
+  sim.SetAxisCount(6);
+  sim.SetRawAxis(rmb::LogitechGamepad::Axes::leftX, 0.03);
+  sim.SetRawAxis(rmb::LogitechGamepad::Axes::leftY, -0.04);
+  sim.SetRawAxis(rmb::LogitechGamepad::Axes::rightX, 0.6);
+  sim.SetRawAxis(rmb::LogitechGamepad::Axes::rightY, -0.8);
+  sim.SetRawAxis(rmb::LogitechGamepad::Axes::leftTrigger, 0.5);
+  sim.SetRawAxis(rmb::LogitechGamepad::Axes::rightTrigger, 0.9);
+  sim.NotifyNewData();
+}
+
+void BM_LogitechGamepadSticks(benchmark::State &state) {
+  setAxes();
+  rmb::LogitechGamepad gamepad(kPort, state.range(0) / 100.0, state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(gamepad.GetLeftX());
+    benchmark::DoNotOptimize(gamepad.GetLeftY());
+    benchmark::DoNotOptimize(gamepad.GetRightX());
+    benchmark::DoNotOptimize(gamepad.GetRightY());
+  }
+}
+BENCHMARK(BM_LogitechGamepadSticks)
+    ->ArgNames({"deadZonePercent", "squareOutputs"})
+    ->Args({0, 0})
+    ->Args({5, 0})
+    ->Args({5, 1});
+
+void BM_LogitechGamepadTriggers(benchmark::State &state) {
+  setAxes();
+  rmb::LogitechGamepad gamepad(kPort, state.range(0) / 100.0, state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(gamepad.GetLeftTrigger());
+    benchmark::DoNotOptimize(gamepad.GetRightTrigger());
+  }
+}
+BENCHMARK(BM_LogitechGamepadTriggers)
+    ->ArgNames({"deadZonePercent", "squareOutputs"})
+    ->Args({0, 0})
+    ->Args({5, 1});
+
+} // namespace
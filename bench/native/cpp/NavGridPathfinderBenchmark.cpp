@@ -0,0 +1,124 @@
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <frc/geometry/Translation2d.h>
+
+#include "units/length.h"
+
+#include "rmb/pathfinding/NavGrid.h"
+#include "rmb/pathfinding/NavGridPathfinder.h"
+
+// Queries run on the navgrid the testbench deploys. RMB_BENCHMARK_NAVGRID is
+// its path, set by the build.
+
+namespace {
+
+constexpr size_t kQueries = 4096;
+
+std::optional<rmb::NavGrid> loadGrid(benchmark::State &state) {
+  std::optional<rmb::NavGrid> grid =
+      rmb::NavGrid::fromFile(RMB_BENCHMARK_NAVGRID);
+  if (!grid) {
+    state.SkipWithError("Could not load " RMB_BENCHMARK_NAVGRID);
+  }
+  return grid;
+}
+
+/**
+ * Start and goal pairs spread uniformly over the field. The seed is fixed so
+ * every run times the same queries. Points inside obstacles are left in,
+ * since the pathfinder moves them to the nearest free cell.
+ */
+std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+makeQueries(const rmb::NavGrid &grid) {
+  std::mt19937 generator(4330);
+  std::uniform_real_distribution<double> x(
+      0.0, (grid.getNodeSize() * grid.getWidth()).value());
+  std::uniform_real_distribution<double> y(
+      0.0, (grid.getNodeSize() * grid.getHeight()).value());
+
+  std::vector<std::pair<frc::Translation2d, frc::Translation2d>> queries;
+  queries.reserve(kQueries);
+  for (size_t i = 0; i < kQueries; i++) {
+    queries.emplace_back(
+        frc::Translation2d(units::meter_t(x(generator)),
+                           units::meter_t(y(generator))),
+        frc::Translation2d(units::meter_t(x(generator)),
+                           units::meter_t(y(generator))));
+  }
+  return queries;
+}
+
+void BM_NavGridPathfinderLoad(benchmark::State &state) {
+  std::optional<rmb::NavGrid> grid = loadGrid(state);
+  if (!grid) {
+    return;
+  }
+
+  for (auto _ : state) {
+    rmb::NavGridPathfinder pathfinder(*grid);
+    benchmark::DoNotOptimize(pathfinder);
+  }
+}
+BENCHMARK(BM_NavGridPathfinderLoad)->Unit(benchmark::kMicrosecond);
+
+void BM_NavGridPathfinderFindPath(benchmark::State &state) {
+  std::optional<rmb::NavGrid> grid = loadGrid(state);
+  if (!grid) {
+    return;
+  }
+
+  rmb::NavGridPathfinder pathfinder(*grid);
+  auto queries = makeQueries(pathfinder.getGrid());
+
+  size_t i = 0;
+  size_t found = 0;
+  for (auto _ : state) {
+    const auto &[start, goal] = queries[i];
+    std::vector<frc::Translation2d> path = pathfinder.findPath(start, goal);
+    found += !path.empty();
+    benchmark::DoNotOptimize(path);
+    i = (i + 1) % kQueries;
+  }
+
+  state.counters["found"] = benchmark::Counter(
+      static_cast<double>(found) / static_cast<double>(state.iterations()));
+}
+BENCHMARK(BM_NavGridPathfinderFindPath)
+    ->Unit(benchmark::kMicrosecond)
+    ->Iterations(kQueries);
+
+/**
+ * Inserts a robot sized obstacle at a new place on the field, then replans
+ * a query, as a robot does when another robot moves into its way.
+ */
+void BM_NavGridPathfinderReplan(benchmark::State &state) {
+  std::optional<rmb::NavGrid> grid = loadGrid(state);
+  if (!grid) {
+    return;
+  }
+
+  rmb::NavGridPathfinder pathfinder(*grid);
+  auto queries = makeQueries(pathfinder.getGrid());
+
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto &[start, goal] = queries[i];
+    const frc::Translation2d &obstacle = queries[(i + 1) % kQueries].first;
+    pathfinder.setDynamicObstacles(
+        {{obstacle - frc::Translation2d(0.5_m, 0.5_m),
+          obstacle + frc::Translation2d(0.5_m, 0.5_m)}});
+    benchmark::DoNotOptimize(pathfinder.findPath(start, goal));
+    i = (i + 1) % kQueries;
+  }
+}
+BENCHMARK(BM_NavGridPathfinderReplan)
+    ->Unit(benchmark::kMicrosecond)
+    ->Iterations(kQueries);
+
+} // namespace
@@ -0,0 +1,135 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include <frc/kinematics/ChassisSpeeds.h>
+
+#include "units/acceleration.h"
+#include "units/angular_velocity.h"
+#include "units/length.h"
+#include "units/math.h"
+#include "units/velocity.h"
+
+#include "BenchmarkDrive.h"
+#include "rmb/drive/SwerveModule.h"
+#include "rmb/drive/SwerveSetpointGenerator.h"
+
+// Every iteration is one robot loop: `sample()` followed by the call being
+// measured. BM_SwerveDriveSample times `sample()` alone. Compare
+// BM_SwerveDriveCartesian/fieldOriented:0 with
+// BM_SwerveDriveCartesianScalarReference for the cost of the inverse
+// kinematics matrix against the old scalar loop.
+
+namespace {
+
+void BM_SwerveDriveSample(benchmark::State &state) {
+  rmb::BenchmarkDrive fixture;
+  for (auto _ : state) {
+    fixture.step();
+  }
+}
+BENCHMARK(BM_SwerveDriveSample);
+
+void BM_SwerveDriveCartesian(benchmark::State &state) {
+  rmb::BenchmarkDrive fixture;
+  bool fieldOriented = state.range(0);
+  for (auto _ : state) {
+    fixture.step();
+    fixture.drive->driveCartesian(0.5, -0.25, 0.3, fieldOriented);
+  }
+}
+BENCHMARK(BM_SwerveDriveCartesian)->ArgName("fieldOriented")->Arg(0)->Arg(1);
+
+/**
+ * The per module scalar loop `driveCartesian()` used before it went through
+ * `openLoopInverseKinematics`, kept so the two can be compared. It drives
+ * the modules through the same `driveModulePowers()`.
+ */
+void driveCartesianScalar(rmb::SwerveDrive<4> &drive, double xSpeed,
+                          double ySpeed, double zRotation) {
+  const auto &translations = rmb::BenchmarkDrive::kModuleTranslations;
+
+  // Computed once at construction, like the drive does.
+  static const units::meter_t largestModuleDistance = [&translations] {
+    units::meter_t distance = 0.0_m;
+    for (const frc::Translation2d &translation : translations) {
+      distance = units::math::max(translation.Norm(), distance);
+    }
+    return distance;
+  }();
+
+  std::array<rmb::SwerveModulePower, 4> powers;
+  double largestPower = 1.0;
+
+  for (size_t i = 0; i < translations.size(); i++) {
+    double output_x =
+        xSpeed + zRotation * translations[i].Y() / largestModuleDistance;
+    double output_y =
+        ySpeed + zRotation * -translations[i].X() / largestModuleDistance;
+
+    frc::Rotation2d moduleRotation{output_x, output_y};
+    double modulePower = std::sqrt(output_x * output_x + output_y * output_y);
+
+    powers[i] = rmb::SwerveModulePower{modulePower, moduleRotation};
+
+    if (modulePower > largestPower) {
+      largestPower = modulePower;
+    }
+  }
+
+  // Normalize
+  for (rmb::SwerveModulePower &power : powers) {
+    power.power /= largestPower;
+  }
+
+  // Optimize
+  for (size_t i = 0; i < translations.size(); i++) {
+    powers[i] = rmb::SwerveModulePower::Optimize(
+        powers[i], drive.getSnapshot().states[i].angle);
+  }
+
+  drive.driveModulePowers(powers);
+}
+
+void BM_SwerveDriveCartesianScalarReference(benchmark::State &state) {
+  rmb::BenchmarkDrive fixture;
+  for (auto _ : state) {
+    fixture.step();
+    driveCartesianScalar(*fixture.drive, 0.5, -0.25, 0.3);
+  }
+}
+BENCHMARK(BM_SwerveDriveCartesianScalarReference);
+
+void BM_SwerveDriveChassisSpeeds(benchmark::State &state) {
+  rmb::BenchmarkDrive fixture;
+  if (state.range(0)) {
+    fixture.drive->setSetpointLimits({8.0_mps_sq, 20.0_rad_per_s});
+  }
+
+  // Alternate between two targets so the setpoint generator never settles.
+  frc::ChassisSpeeds targets[2] = {{2.0_mps, -1.0_mps, 1.5_rad_per_s},
+                                   {-2.0_mps, 1.0_mps, -1.5_rad_per_s}};
+  size_t i = 0;
+  for (auto _ : state) {
+    fixture.step();
+    fixture.drive->driveChassisSpeeds(targets[i]);
+    i ^= 1;
+  }
+}
+BENCHMARK(BM_SwerveDriveChassisSpeeds)
+    ->ArgName("setpointLimits")
+    ->Arg(0)
+    ->Arg(1);
+
+void BM_SwerveDriveUpdatePose(benchmark::State &state) {
+  rmb::BenchmarkDrive fixture;
+  for (auto _ : state) {
+    fixture.step();
+    benchmark::DoNotOptimize(fixture.drive->updatePose());
+  }
+}
+BENCHMARK(BM_SwerveDriveUpdatePose);
+
+} // namespace
@@ -0,0 +1,43 @@
+#include <array>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include "units/angle.h"
+
+#include "rmb/drive/SwerveModule.h"
+
+namespace {
+
+constexpr size_t kInputs = 64;
+
+/**
+ * Desired powers spread around the circle, each paired with a current angle
+ * so that half of them need the wheel reversed.
+ */
+struct OptimizeInputs {
+  std::array<rmb::SwerveModulePower, kInputs> desired;
+  std::array<frc::Rotation2d, kInputs> current;
+
+  OptimizeInputs() {
+    for (size_t i = 0; i < kInputs; i++) {
+      units::degree_t angle = 360_deg * static_cast<double>(i) / kInputs;
+      desired[i] = {0.75, frc::Rotation2d(angle)};
+      current[i] = frc::Rotation2d(angle + (i % 2 == 0 ? 30_deg : 150_deg));
+    }
+  }
+};
+
+void BM_SwerveModulePowerOptimize(benchmark::State &state) {
+  OptimizeInputs inputs;
+  size_t i = 0;
+  for (auto _ : state) {
+    rmb::SwerveModulePower power = rmb::SwerveModulePower::Optimize(
+        inputs.desired[i], inputs.current[i]);
+    benchmark::DoNotOptimize(power);
+    i = (i + 1) % kInputs;
+  }
+}
+BENCHMARK(BM_SwerveModulePowerOptimize);
+
+} // namespace
@@ -0,0 +1,17 @@
+#include <benchmark/benchmark.h>
+
+#include <hal/HALBase.h>
+
+int main(int argc, char **argv) {
+  // The gamepad benchmarks read joysticks through the simulated HAL.
+  HAL_Initialize(500, 0);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <networktables/NetworkTableInstance.h>
+
+#include <frc/controller/HolonomicDriveController.h>
+#include <frc/controller/PIDController.h>
+#include <frc/controller/ProfiledPIDController.h>
+#include <frc/geometry/Translation2d.h>
+
+#include "units/angle.h"
+#include "units/length.h"
+#include "units/time.h"
+#include "units/velocity.h"
+
+#include "MockControllers.h"
+#include "rmb/drive/SwerveDrive.h"
+#include "rmb/drive/SwerveModule.h"
+
+namespace rmb {
+
+/**
+ * Four module swerve drive on mock controllers, with its own NetworkTables
+ * instance and a clock the benchmark advances by hand.
+ */
+class BenchmarkDrive {
+public:
+  BenchmarkDrive() : ntInstance(nt::NetworkTableInstance::Create()) {
+    std::array<SwerveModule, 4> modules = {
+        makeModule(kModuleTranslations[0]), makeModule(kModuleTranslations[1]),
+        makeModule(kModuleTranslations[2]), makeModule(kModuleTranslations[3])};
+
+    drive = std::make_unique<SwerveDrive<4>>(
+        std::move(modules), gyro,
+        frc::HolonomicDriveController(
+            frc::PIDController(1.0, 0.0, 0.0),
+            frc::PIDController(1.0, 0.0, 0.0),
+            frc::ProfiledPIDController<units::radian>(
+                1, 0, 0,
+                frc::TrapezoidProfile<units::radian>::Constraints(
+                    6.28_rad_per_s, 3.14_rad_per_s / 1_s))),
+        4.5_mps, frc::Pose2d(),
+        SwerveDriveEnvironment{ntInstance, [this] { return time; }});
+    drive->sample();
+  }
+
+  BenchmarkDrive(const BenchmarkDrive &) = delete;
+  BenchmarkDrive &operator=(const BenchmarkDrive &) = delete;
+
+  ~BenchmarkDrive() {
+    drive.reset();
+    nt::NetworkTableInstance::Destroy(ntInstance);
+  }
+
+  /**
+   * Advances the clock by one robot loop and samples the modules, as a robot
+   * does at the start of every loop.
+   */
+  void step() {
+    time += 20_ms;
+    drive->sample();
+  }
+
+  static inline const std::array<frc::Translation2d, 4> kModuleTranslations{
+      frc::Translation2d(-1_ft, 1_ft), frc::Translation2d(1_ft, 1_ft),
+      frc::Translation2d(1_ft, -1_ft), frc::Translation2d(-1_ft, -1_ft)};
+
+  std::shared_ptr<MockGyro> gyro = std::make_shared<MockGyro>();
+  std::unique_ptr<SwerveDrive<4>> drive;
+
+private:
+  static SwerveModule makeModule(const frc::Translation2d &translation) {
+    return SwerveModule(std::make_unique<MockLinearVelocityController>(),
+                        std::make_unique<MockAngularPositionController>(),
+                        translation);
+  }
+
+  nt::NetworkTableInstance ntInstance;
+  units::second_t time = 1_s;
+};
+
+} // namespace rmb
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <limits>
+
+#include <units/acceleration.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/length.h>
+#include <units/velocity.h>
+
+#include <frc/geometry/Rotation2d.h>
+
+#include "rmb/motorcontrol/AngularPositionController.h"
+#include "rmb/motorcontrol/AngularVelocityController.h"
+#include "rmb/motorcontrol/LinearPositionController.h"
+#include "rmb/motorcontrol/LinearVelocityController.h"
+#include "rmb/sensors/gyro.h"
+
+namespace rmb {
+
+/**
+ * Velocity controller that reaches its target instantly and does nothing
+ * else, so benchmarks measure the code driving it rather than the hardware.
+ */
+class MockAngularVelocityController : public AngularVelocityController {
+public:
+  void setVelocity(units::radians_per_second_t velocity) override {
+    target = velocity;
+    this->velocity = velocity;
+  }
+  units::radians_per_second_t getTargetVelocity() const override {
+    return target;
+  }
+
+  void setPower(double power) override { this->power = power; }
+  double getPower() const override { return power; }
+
+  void disable() override { power = 0.0; }
+  void stop() override { power = 0.0; }
+
+  units::radians_per_second_t getVelocity() const override { return velocity; }
+  units::radian_t getPosition() const override { return position; }
+  void setEncoderPosition(units::radian_t position = 0_rad) override {
+    this->position = position;
+  }
+
+  units::radians_per_second_t getTolerance() const override {
+    return 0.1_rad_per_s;
+  }
+
+private:
+  units::radians_per_second_t target = 0_rad_per_s;
+  units::radians_per_second_t velocity = 0_rad_per_s;
+  units::radian_t position = 0_rad;
+  double power = 0.0;
+};
+
+/**
+ * Linear counterpart of `MockAngularVelocityController`.
+ */
+class MockLinearVelocityController : public LinearVelocityController {
+public:
+  void setVelocity(units::meters_per_second_t velocity) override {
+    target = velocity;
+    this->velocity = velocity;
+  }
+  units::meters_per_second_t getTargetVelocity() const override {
+    return target;
+  }
+
+  void setPower(double power) override { this->power = power; }
+  double getPower() const override { return power; }
+
+  void disable() override { power = 0.0; }
+  void stop() override { power = 0.0; }
+
+  units::meters_per_second_t getVelocity() const override { return velocity; }
+  units::meter_t getPosition() const override { return position; }
+  void setEncoderPosition(units::meter_t position = 0_m) override {
+    this->position = position;
+  }
+
+  units::meters_per_second_t getTolerance() const override { return 0.05_mps; }
+
+private:
+  units::meters_per_second_t target = 0_mps;
+  units::meters_per_second_t velocity = 0_mps;
+  units::meter_t position = 0_m;
+  double power = 0.0;
+};
+
+/**
+ * Position controller that reaches its target instantly.
+ */
+class MockAngularPositionController : public AngularPositionController {
+public:
+  void setPosition(units::radian_t position) override {
+    target = position;
+    this->position = position;
+  }
+  units::radian_t getTargetPosition() const override { return target; }
+
+  void setPower(double power) override { this->power = power; }
+  double getPower() const override { return power; }
+
+  units::radian_t getMinPosition() const override {
+    return units::radian_t(-std::numeric_limits<double>::infinity());
+  }
+  units::radian_t getMaxPosition() const override {
+    return units::radian_t(std::numeric_limits<double>::infinity());
+  }
+
+  void disable() override { power = 0.0; }
+  void stop() override { power = 0.0; }
+
+  units::radians_per_second_t getVelocity() const override {
+    return 0_rad_per_s;
+  }
+  units::radian_t getPosition() const override { return position; }
+  void setEncoderPosition(units::radian_t position = 0_rad) override {
+    this->position = position;
+  }
+
+  units::radian_t getTolerance() const override { return 0.01_rad; }
+
+private:
+  units::radian_t target = 0_rad;
+  units::radian_t position = 0_rad;
+  double power = 0.0;
+};
+
+/**
+ * Linear counterpart of `MockAngularPositionController`.
+ */
+class MockLinearPositionController : public LinearPositionController {
+public:
+  void setPosition(units::meter_t position) override {
+    target = position;
+    this->position = position;
+  }
+  units::meter_t getTargetPosition() const override { return target; }
+
+  void setPower(double power) override { this->power = power; }
+  double getPower() const override { return power; }
+
+  units::meter_t getMinPosition() const override {
+    return units::meter_t(-std::numeric_limits<double>::infinity());
+  }
+  units::meter_t getMaxPosition() const override {
+    return units::meter_t(std::numeric_limits<double>::infinity());
+  }
+
+  void disable() override { power = 0.0; }
+  void stop() override { power = 0.0; }
+
+  units::meters_per_second_t getVelocity() const override { return 0_mps; }
+  units::meter_t getPosition() const override { return position; }
+  void setEncoderPosition(units::meter_t position = 0_m) override {
+    this->position = position;
+  }
+
+  units::meter_t getTolerance() const override { return 0.01_m; }
+
+private:
+  units::meter_t target = 0_m;
+  units::meter_t position = 0_m;
+  double power = 0.0;
+};
+
+/**
+ * Gyro reporting a fixed heading and no motion.
+ */
+class MockGyro : public Gyro {
+public:
+  units::turn_t getZRotation() const override { return heading; }
+  frc::Rotation2d getRotation() const override {
+    return frc::Rotation2d(heading);
+  }
+  void resetZRotation() override { heading = 0_tr; }
+
+  units::meters_per_second_squared_t getXAcceleration() const override {
+    return 0_mps_sq;
+  }
+  units::meters_per_second_squared_t getYAcceleration() const override {
+    return 0_mps_sq;
+  }
+  units::meters_per_second_squared_t getZAcceleration() const override {
+    return 0_mps_sq;
+  }
+
+  units::meters_per_second_t getXVelocity() const override { return 0_mps; }
+  units::meters_per_second_t getYVelocity() const override { return 0_mps; }
+  units::meters_per_second_t getZVelocity() const override { return 0_mps; }
+
+  units::turn_t heading = 0.1_tr; /* <- Reported heading. */
+};
+
+} // namespace rmb
@@ -1,6 +1,7 @@
 #include "rmb/drive/BaseDrive.h"
 #include "frc2/command/CommandPtr.h"
 
+#include <algorithm>
 #include <typeinfo>
 
 #include <frc2/command/Commands.h>
@@ -9,58 +10,114 @@
 #include <pathplanner/lib/commands/FollowPathWithEvents.h>
 #include <pathplanner/lib/controllers/PPRamseteController.h>
 
+#include "rmb/util/Profiler.h"
+
 namespace rmb {
-BaseDrive::BaseDrive(std::string visionTable) {
-  // Get vision table.
-  nt::NetworkTableInstance inst = nt::NetworkTableInstance::GetDefault();
-  auto table = inst.GetTable(visionTable);
-
-  // Get positon and standard deviation topics.
-  poseSubscriber = table->GetDoubleArrayTopic("pose").Subscribe({});
-  stdDevSubscriber = table->GetDoubleArrayTopic("stdDev").Subscribe({});
-
-  // Create positon callback
-  poseListener = inst.AddListener(
-      poseSubscriber, nt::EventFlags::kValueAll,
-      [this](const nt::Event &event) {
-        // Get timestamped data.
-        nt::TimestampedDoubleArray rawData = poseSubscriber.GetAtomic();
-
-        // Check data format.
-        if (rawData.value.size() != 3) {
-          return;
-        }
-
-        // Extract positon and time.
-        frc::Pose2d pose = {units::meter_t(rawData.value[0]),
-                            units::meter_t(rawData.value[1]),
-                            units::radian_t(rawData.value[2])};
-
-        units::second_t time = units::microsecond_t(rawData.time);
-
-        addVisionMeasurments(pose, time);
-      });
-
-  // Create standard deviation callback
-  stdDevListener =
-      inst.AddListener(stdDevSubscriber, nt::EventFlags::kValueAll,
-                       [this](const nt::Event &event) {
-                         // Get data from table.
-                         std::vector<double> rawData = stdDevSubscriber.Get();
-
-                         // Check data format
-                         if (rawData.size() != 3) {
-                           return;
-                         }
-
-                         setVisionSTDevs({rawData[0], rawData[1], rawData[2]});
-                       });
+BaseDrive::BaseDrive(const std::vector<std::string> &cameraTables,
+                     nt::NetworkTableInstance ntInstance) {
+  // Subscribe to every camera before adding listeners so the vector is never
+  // resized while a listener is reading it.
+  visionCameras.reserve(cameraTables.size());
+  for (const std::string &cameraTable : cameraTables) {
+    if (!cameraTable.empty()) {
+      visionCameras.push_back(
+          {ntInstance.GetTable(cameraTable)
+               ->GetDoubleArrayTopic("measurement")
+               .Subscribe({})});
+    }
+  }
+
+  for (size_t camera = 0; camera < visionCameras.size(); camera++) {
+    visionCameras[camera].listener = ntInstance.AddListener(
+        visionCameras[camera].subscriber, nt::EventFlags::kValueAll,
+        [this, camera](const nt::Event &event) {
+          handleVisionEvent(event, camera);
+        });
+  }
+}
+
+void BaseDrive::handleVisionEvent(const nt::Event &event, size_t camera) {
+  RMB_PROFILE_ZONE("BaseDrive::visionListener");
+
+  // Read the value carried by the event in place rather than copying out the
+  // latest one with Get(), which allocates on every record and could skip
+  // back to back records.
+  const nt::ValueEventData *data = event.GetValueEventData();
+  if (!data || !data->value.IsDoubleArray()) {
+    return;
+  }
+
+  std::optional<VisionMeasurement> measurement =
+      parseVisionRecord(data->value.GetDoubleArray(),
+                        units::microsecond_t(data->value.time()), camera);
+  if (!measurement) {
+    return;
+  }
+
+  // Hand off to the pose thread rather than locking the estimator here.
+  if (!visionMeasurements.push(*measurement)) {
+    droppedVisionMeasurements.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
+std::optional<VisionMeasurement>
+BaseDrive::parseVisionRecord(std::span<const double> record,
+                             units::second_t publishTime, size_t camera) {
+  // Check data format. Records from before the tag distance was added are
+  // one shorter.
+  if (record.size() != kVisionRecordSize &&
+      record.size() != kVisionRecordSize - 1) {
+    return std::nullopt;
+  }
+
+  VisionMeasurement measurement;
+  measurement.pose = {units::meter_t(record[0]), units::meter_t(record[1]),
+                      units::radian_t(record[2])};
+  measurement.timestamp =
+      record[3] > 0.0 ? units::second_t(record[3]) : publishTime;
+  measurement.tagCount = static_cast<int>(record[4]);
+  measurement.ambiguity = record[5];
+  measurement.camera = camera;
+
+  if (record[6] > 0.0 || record[7] > 0.0 || record[8] > 0.0) {
+    measurement.stdDevs =
+        wpi::array<double, 3>{record[6], record[7], record[8]};
+  }
+
+  if (record.size() == kVisionRecordSize) {
+    measurement.tagDistance = units::meter_t(record[9]);
+  }
+
+  return measurement;
+}
+
+BaseDrive::BaseDrive(std::string visionTable)
+    : BaseDrive(std::vector<std::string>{visionTable}) {}
+
 BaseDrive::~BaseDrive() {
   // Remove listeners.
-  nt::RemoveListener(poseListener);
-  nt::RemoveListener(stdDevListener);
+  for (VisionCamera &camera : visionCameras) {
+    if (camera.listener) {
+      nt::RemoveListener(camera.listener);
+    }
+  }
+}
+
+std::span<const VisionMeasurement> BaseDrive::takeVisionMeasurements() {
+  size_t count = 0;
+  while (count < visionBatch.size() &&
+         visionMeasurements.pop(visionBatch[count])) {
+    count++;
+  }
+
+  // Cameras report with different latencies, so interleave them by capture
+  // time before they reach the estimator.
+  std::sort(visionBatch.begin(), visionBatch.begin() + count,
+            [](const VisionMeasurement &a, const VisionMeasurement &b) {
+              return a.timestamp < b.timestamp;
+            });
+
+  return {visionBatch.data(), count};
 }
 
 frc2::CommandPtr BaseDrive::followWPILibTrajectoryGroup(
@@ -1,15 +1,22 @@
 #pragma once
 
 #include "pathplanner/lib/path/PathPlannerPath.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <initializer_list>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <units/time.h>
 
 #include <wpi/array.h>
 
+#include <frc/geometry/Pose2d.h>
 #include <frc/interfaces/Gyro.h>
 #include <frc/kinematics/ChassisSpeeds.h>
 #include <frc/trajectory/Trajectory.h>
@@ -23,8 +30,29 @@
 
 #include <pathplanner/lib/path/PathPlannerTrajectory.h>
 
+#include "rmb/util/SPSCQueue.h"
+
 namespace rmb {
 
+/**
+ * A single vision pose estimate received over NetworkTables waiting to be
+ * applied to a drive's pose estimator.
+ */
+struct VisionMeasurement {
+  frc::Pose2d pose;                 /* <- Estimated robot position. */
+  units::second_t timestamp = 0_s;  /* <- Capture time, same epoch as nt::Now */
+  int tagCount = 0;                 /* <- Number of tags seen. */
+  double ambiguity = 0.0;           /* <- Pose ambiguity reported. */
+  units::meter_t tagDistance = 0_m; /* <- Mean distance to the tags, or 0. */
+  size_t camera = 0;                /* <- Index of the camera table. */
+
+  /**
+   * Standard deviations ordered X, Y, Theta, or nothing to use the drive's
+   * default vision standard deviations.
+   */
+  std::optional<wpi::array<double, 3>> stdDevs;
+};
+
 /**
  * Base interface for robot drive classes that can handle automatic updating
  * of vision based odometry and more complex path following.
@@ -37,21 +65,60 @@ protected:
 
   /**
    * Constructs a base drive class capable of automatically listening for
-   * vision based odometry over the network via NetworkTables.
+   * vision based odometry from any number of cameras over NetworkTables.
+   *
+   * @param cameraTables Paths to the NetworkTables table of each camera. Each
+   *                     table should include a DoubleArrayTopic titled
+   *                     `measurement` holding one packed record per
+   *                     estimate, so a pose and its standard deviations can
+   *                     never be mismatched. See `kVisionRecordSize` for the
+   *                     layout. Empty paths are ignored.
+   * @param ntInstance   NetworkTables instance the cameras publish to.
+   */
+  BaseDrive(const std::vector<std::string> &cameraTables,
+            nt::NetworkTableInstance ntInstance =
+                nt::NetworkTableInstance::GetDefault());
+
+  /**
+   * Constructs a base drive class listening to a single camera.
    *
-   * @param visionTable Path to NetworkTables table for listening for vision
-   *                    based odometry updates. This table whould include two
-   *                    DoubleArrayTopics. One titled `pose` with three entries
-   *                    ordered X, Y, Theta in meters and radians. The other
-   *                    should be names `stDev` with three entris again ordered
-   *                    X, Y, Theta with units meters and radians. Always
-   *                    update stDev before pose.
+   * @param visionTable Path to the camera's NetworkTables table, laid out as
+   *                    described above. An empty path disables vision.
    */
   BaseDrive(std::string visionTable);
 
   virtual ~BaseDrive();
 
 public:
+  /**
+   * Number of entries in a camera's `measurement` record, ordered:
+   *
+   * X, Y, Theta of the robot pose (meters and radians), capture timestamp
+   * (seconds, same epoch as nt::Now(), or zero to use the time the record
+   * was published), number of tags seen, pose ambiguity, standard
+   * deviations X, Y, Theta (meters and radians, or all zero to use the
+   * drive's defaults), and mean distance to the tags seen (meters, or zero
+   * if unknown).
+   *
+   * Records without the tag distance are also accepted.
+   */
+  static constexpr size_t kVisionRecordSize = 10;
+
+  /**
+   * Unpacks a camera's `measurement` record. Reads the record in place and
+   * never allocates, so it is safe to run for every frame of every camera.
+   *
+   * @param record      The packed record.
+   * @param publishTime Time the record was published, used when the record
+   *                    has no capture timestamp.
+   * @param camera      Index of the camera the record came from.
+   *
+   * @return The measurement, or nothing if the record is malformed.
+   */
+  static std::optional<VisionMeasurement>
+  parseVisionRecord(std::span<const double> record,
+                    units::second_t publishTime, size_t camera);
+
   //---------------
   // Drive Methods
   //---------------
@@ -117,6 +184,14 @@ public:
    */
   virtual void resetPose(const frc::Pose2d &pose = frc::Pose2d()) = 0;
 
+  /**
+   * Returns the number of vision measurements discarded because they arrived
+   * faster than `updatePose()` consumed them.
+   */
+  size_t getDroppedVisionMeasurements() const {
+    return droppedVisionMeasurements.load(std::memory_order_relaxed);
+  }
+
   //----------------------
   // Trajectory Following
   //----------------------
@@ -264,30 +339,54 @@ protected:
   //---------------
 
   /**
-   * Network Tables subscriber for vision position predictions.
+   * Takes every vision measurement received from any camera since the last
+   * call, oldest capture first. Must only be called from the thread that
+   * updates the pose, typically at the start of `updatePose()`. This never
+   * allocates.
    *
-   * Data is sent in a three entry double array ordered X, Y, Theta. X and Y
-   * are in meters and Theta is in radians.
+   * @return The measurements, valid until the next call.
    */
-  nt::DoubleArraySubscriber poseSubscriber;
+  std::span<const VisionMeasurement> takeVisionMeasurements();
 
   /**
-   * Network Tables subscriber for the standard deviation of vision predictions.
+   * Parses a record from a camera's listener and queues it for
+   * `takeVisionMeasurements()`. Called on the NetworkTables listener thread,
+   * and must never be called from two threads at once. This never allocates.
    *
-   * Data is sent in a three entry double array ordered X, Y, Theta. X and Y
-   * are in meters and Theta is in radians. The standard deviations are a
-   * measure of how much the reported position typically deviates from the true
-   * position. Larger values denote less accuracy in vision data, while smaller
-   * values denote higher accuracy.
+   * @param event  Value event for the camera's `measurement` topic.
+   * @param camera Index of the camera in `visionCameras`.
+   */
+  void handleVisionEvent(const nt::Event &event, size_t camera);
+
+  /**
+   * Subscription to one camera's table.
    */
-  nt::DoubleArraySubscriber stdDevSubscriber;
+  struct VisionCamera {
+    nt::DoubleArraySubscriber subscriber;
+    NT_Listener listener = 0;
+  };
 
-  /** Handle for keeping track of vision position callback for position. */
-  NT_Listener poseListener;
+  /**
+   * Cameras listened to. Never resized after construction, since the
+   * listeners refer to their subscribers.
+   */
+  std::vector<VisionCamera> visionCameras;
 
-  /** Handle for keeping track of vision position standard deviations callback
-   * for position.
+private:
+  static constexpr size_t kVisionQueueSize = 64;
+
+  /**
+   * Measurements passed from the NetworkTables listener thread to the thread
+   * updating the pose without either of them ever blocking. NetworkTables
+   * calls every listener from one thread, so all cameras share the queue.
    */
-  NT_Listener stdDevListener;
+  SPSCQueue<VisionMeasurement, kVisionQueueSize> visionMeasurements;
+
+  /**
+   * Measurements returned by the last `takeVisionMeasurements()`.
+   */
+  std::array<VisionMeasurement, kVisionQueueSize> visionBatch;
+
+  std::atomic<size_t> droppedVisionMeasurements = 0;
 };
 } // namespace rmb
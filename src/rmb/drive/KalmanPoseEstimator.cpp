@@ -0,0 +1,232 @@
+#include "rmb/drive/KalmanPoseEstimator.h"
+
+#include <cmath>
+#include <optional>
+
+#include <Eigen/LU>
+
+#include <frc/MathUtil.h>
+#include <frc/geometry/Transform2d.h>
+#include <frc/geometry/Twist2d.h>
+
+namespace rmb {
+
+namespace {
+
+enum StateIndex { kX, kY, kHeading, kVx, kVy, kOmega, kGyroOffset };
+
+Eigen::Matrix<double, 3, 3> toCovariance(const wpi::array<double, 3> &stdDevs) {
+  return Eigen::Vector3d(stdDevs[0] * stdDevs[0], stdDevs[1] * stdDevs[1],
+                         stdDevs[2] * stdDevs[2])
+      .asDiagonal();
+}
+
+} // namespace
+
+KalmanPoseEstimator::KalmanPoseEstimator(
+    const KalmanPoseEstimatorHelper::NoiseConfig &noise,
+    const frc::Rotation2d &gyroAngle, const frc::Pose2d &initialPose,
+    units::second_t timestamp)
+    : noise(noise), odometryNoise(toCovariance(noise.odometry)),
+      visionNoise(toCovariance(noise.vision)) {
+  reset(gyroAngle, initialPose, timestamp);
+}
+
+frc::Pose2d
+KalmanPoseEstimator::update(units::second_t timestamp,
+                            const frc::Rotation2d &gyroAngle,
+                            const frc::ChassisSpeeds &speeds,
+                            units::meters_per_second_squared_t xAcceleration,
+                            units::meters_per_second_squared_t yAcceleration) {
+  const double dt = (timestamp - this->timestamp).value();
+
+  if (dt > 0.0) {
+    this->timestamp = timestamp;
+
+    //---------
+    // Predict
+    //---------
+
+    const double heading = state(kHeading);
+    const double vx = state(kVx), vy = state(kVy), omega = state(kOmega);
+    const double cosHeading = std::cos(heading), sinHeading = std::sin(heading);
+
+    // Velocity is robot relative, so turning rotates it: v' = a - omega x v.
+    state(kX) += (cosHeading * vx - sinHeading * vy) * dt;
+    state(kY) += (sinHeading * vx + cosHeading * vy) * dt;
+    state(kHeading) += omega * dt;
+    state(kVx) += (xAcceleration.value() + omega * vy) * dt;
+    state(kVy) += (yAcceleration.value() - omega * vx) * dt;
+
+    Covariance jacobian = Covariance::Identity();
+    jacobian(kX, kHeading) = (-sinHeading * vx - cosHeading * vy) * dt;
+    jacobian(kX, kVx) = cosHeading * dt;
+    jacobian(kX, kVy) = -sinHeading * dt;
+    jacobian(kY, kHeading) = (cosHeading * vx - sinHeading * vy) * dt;
+    jacobian(kY, kVx) = sinHeading * dt;
+    jacobian(kY, kVy) = cosHeading * dt;
+    jacobian(kHeading, kOmega) = dt;
+    jacobian(kVx, kVy) = omega * dt;
+    jacobian(kVx, kOmega) = vy * dt;
+    jacobian(kVy, kVx) = -omega * dt;
+    jacobian(kVy, kOmega) = -vx * dt;
+
+    const double velocityNoise = noise.acceleration.value() * dt;
+    const double omegaNoise = noise.angularAcceleration.value() * dt;
+
+    covariance = jacobian * covariance * jacobian.transpose();
+    covariance(kVx, kVx) += velocityNoise * velocityNoise;
+    covariance(kVy, kVy) += velocityNoise * velocityNoise;
+    covariance(kOmega, kOmega) += omegaNoise * omegaNoise;
+    covariance(kGyroOffset, kGyroOffset) +=
+        noise.headingDrift * noise.headingDrift * dt;
+
+    //----------
+    // Odometry
+    //----------
+
+    Eigen::Matrix<double, 3, kStates> odometryMeasurement =
+        Eigen::Matrix<double, 3, kStates>::Zero();
+    odometryMeasurement(0, kVx) = 1.0;
+    odometryMeasurement(1, kVy) = 1.0;
+    odometryMeasurement(2, kOmega) = 1.0;
+
+    correct<3>(odometryMeasurement,
+               Eigen::Vector3d(speeds.vx.value() - state(kVx),
+                               speeds.vy.value() - state(kVy),
+                               speeds.omega.value() - state(kOmega)),
+               odometryNoise);
+
+    // Dead reckoning for vision latency compensation.
+    odometryPose = odometryPose.Exp(
+        {speeds.vx * units::second_t(dt), speeds.vy * units::second_t(dt),
+         (gyroAngle - lastGyroAngle).Radians()});
+  }
+
+  //------
+  // Gyro
+  //------
+
+  // The gyro reads the field heading less the field heading of its zero.
+  Eigen::Matrix<double, 1, kStates> headingMeasurement =
+      Eigen::Matrix<double, 1, kStates>::Zero();
+  headingMeasurement(0, kHeading) = 1.0;
+  headingMeasurement(0, kGyroOffset) = -1.0;
+
+  units::radian_t headingResidual = frc::AngleModulus(
+      gyroAngle.Radians() -
+      units::radian_t(state(kHeading) - state(kGyroOffset)));
+  const double headingNoise = noise.heading.value() * noise.heading.value();
+
+  correct<1>(headingMeasurement,
+             Eigen::Matrix<double, 1, 1>(headingResidual.value()),
+             Eigen::Matrix<double, 1, 1>(headingNoise));
+
+  lastGyroAngle = gyroAngle;
+  odometryHistory.record({this->timestamp, odometryPose, speeds});
+
+  return getPose();
+}
+
+bool KalmanPoseEstimator::addVisionMeasurement(const frc::Pose2d &visionPose,
+                                               units::second_t timestamp) {
+  std::optional<TimestampedPose> captured = odometryHistory.sample(timestamp);
+  if (!captured) {
+    return false;
+  }
+
+  // Where the robot seen by the camera is now, by odometry.
+  frc::Pose2d current =
+      visionPose.TransformBy(frc::Transform2d(captured->pose, odometryPose));
+
+  Eigen::Matrix<double, 3, kStates> visionMeasurement =
+      Eigen::Matrix<double, 3, kStates>::Zero();
+  visionMeasurement(0, kX) = 1.0;
+  visionMeasurement(1, kY) = 1.0;
+  visionMeasurement(2, kHeading) = 1.0;
+
+  units::radian_t headingResidual = frc::AngleModulus(
+      current.Rotation().Radians() - units::radian_t(state(kHeading)));
+
+  correct<3>(visionMeasurement,
+             Eigen::Vector3d(current.X().value() - state(kX),
+                             current.Y().value() - state(kY),
+                             headingResidual.value()),
+             visionNoise);
+
+  return true;
+}
+
+bool KalmanPoseEstimator::addVisionMeasurement(
+    const frc::Pose2d &visionPose, units::second_t timestamp,
+    const wpi::array<double, 3> &stdDevs) {
+  Eigen::Matrix<double, 3, 3> defaultNoise = visionNoise;
+  visionNoise = toCovariance(stdDevs);
+
+  bool applied = addVisionMeasurement(visionPose, timestamp);
+
+  visionNoise = defaultNoise;
+  return applied;
+}
+
+void KalmanPoseEstimator::setVisionStdDevs(
+    const wpi::array<double, 3> &stdDevs) {
+  noise.vision = stdDevs;
+  visionNoise = toCovariance(stdDevs);
+}
+
+void KalmanPoseEstimator::reset(const frc::Rotation2d &gyroAngle,
+                                const frc::Pose2d &pose,
+                                units::second_t timestamp) {
+  const double heading = pose.Rotation().Radians().value();
+
+  state.setZero();
+  state(kX) = pose.X().value();
+  state(kY) = pose.Y().value();
+  state(kHeading) = heading;
+  state(kGyroOffset) = heading - gyroAngle.Radians().value();
+
+  // The pose is known exactly, but not how the robot is moving.
+  covariance.setZero();
+  covariance(kVx, kVx) = odometryNoise(0, 0);
+  covariance(kVy, kVy) = odometryNoise(1, 1);
+  covariance(kOmega, kOmega) = odometryNoise(2, 2);
+
+  this->timestamp = timestamp;
+  odometryPose = pose;
+  lastGyroAngle = gyroAngle;
+
+  odometryHistory.clear();
+  odometryHistory.record({timestamp, odometryPose, frc::ChassisSpeeds()});
+}
+
+frc::Pose2d KalmanPoseEstimator::getPose() const {
+  return frc::Pose2d(units::meter_t(state(kX)), units::meter_t(state(kY)),
+                     frc::Rotation2d(units::radian_t(state(kHeading))));
+}
+
+frc::ChassisSpeeds KalmanPoseEstimator::getChassisSpeeds() const {
+  return {units::meters_per_second_t(state(kVx)),
+          units::meters_per_second_t(state(kVy)),
+          units::radians_per_second_t(state(kOmega))};
+}
+
+template <int Rows>
+void KalmanPoseEstimator::correct(
+    const Eigen::Matrix<double, Rows, kStates> &measurement,
+    const Eigen::Matrix<double, Rows, 1> &residual,
+    const Eigen::Matrix<double, Rows, Rows> &measurementNoise) {
+  const Eigen::Matrix<double, Rows, Rows> innovationCovariance =
+      measurement * covariance * measurement.transpose() + measurementNoise;
+  const Eigen::Matrix<double, kStates, Rows> gain =
+      covariance * measurement.transpose() * innovationCovariance.inverse();
+
+  state += gain * residual;
+  state(kHeading) = frc::AngleModulus(units::radian_t(state(kHeading))).value();
+
+  const Covariance reduction = Covariance::Identity() - gain * measurement;
+  covariance = reduction * covariance * reduction.transpose() +
+               gain * measurementNoise * gain.transpose();
+}
+
+} // namespace rmb
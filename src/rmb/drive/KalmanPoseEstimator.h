@@ -0,0 +1,199 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Rotation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <wpi/array.h>
+
+#include "units/acceleration.h"
+#include "units/angle.h"
+#include "units/angular_acceleration.h"
+#include "units/time.h"
+
+#include "rmb/drive/PoseHistory.h"
+
+namespace rmb {
+
+namespace KalmanPoseEstimatorHelper {
+
+/**
+ * Standard deviations of the noise in each input of a `KalmanPoseEstimator`.
+ * Larger values trust that input less.
+ */
+struct NoiseConfig {
+  /** Accelerometer noise and unmodeled pushes on the robot. */
+  units::meters_per_second_squared_t acceleration = 1.0_mps_sq;
+
+  /** Unmodeled angular acceleration of the robot. */
+  units::radians_per_second_squared_t angularAcceleration = 10.0_rad_per_s_sq;
+
+  /** Odometry speeds, ordered X, Y (m/s) and Theta (rad/s). */
+  wpi::array<double, 3> odometry{0.1, 0.1, 0.1};
+
+  units::radian_t heading = 0.002_rad; /*< Gyro noise on each reading. */
+
+  /** Gyro drift, in radians per square root of a second. */
+  double headingDrift = 0.001;
+
+  /** Vision poses, ordered X, Y (meters) and Theta (radians). */
+  wpi::array<double, 3> vision{0.9, 0.9, 0.9};
+};
+} // namespace KalmanPoseEstimatorHelper
+
+/**
+ * Extended Kalman filter estimating the pose of a drivetrain from odometry,
+ * the gyro's heading and acceleration, and latency compensated vision. It is
+ * an alternative to the WPILib pose estimators that also uses the
+ * accelerometer. The odometry then corrects the velocity rather than
+ * integrating straight into the pose, so wheel slip shows up as a
+ * disagreement between them instead of as pose error.
+ *
+ * The filter tracks the field relative pose, the robot relative velocity and
+ * the offset between the gyro and field headings, so vision can correct the
+ * heading without fighting the gyro. Every operation works on fixed-size
+ * matrices and never allocates, so each update and vision measurement costs
+ * the same bounded time.
+ *
+ * This class is not synchronized. Users sharing it between threads must lock
+ * around it.
+ */
+class KalmanPoseEstimator {
+public:
+  static constexpr int kStates = 7;
+
+  /**
+   * Estimated state: X and Y (meters), heading (radians), robot relative X
+   * and Y velocity (m/s), angular velocity (rad/s) and the field heading of
+   * the gyro's zero (radians).
+   */
+  using State = Eigen::Matrix<double, kStates, 1>;
+  using Covariance = Eigen::Matrix<double, kStates, kStates>;
+
+  /**
+   * Constructs an estimator.
+   *
+   * @param noise       Noise of each input.
+   * @param gyroAngle   Heading reported by the gyro at `timestamp`.
+   * @param initialPose Starting position of the robot.
+   * @param timestamp   Time of the starting position.
+   */
+  KalmanPoseEstimator(const KalmanPoseEstimatorHelper::NoiseConfig &noise,
+                      const frc::Rotation2d &gyroAngle,
+                      const frc::Pose2d &initialPose,
+                      units::second_t timestamp);
+
+  /**
+   * Predicts forward to `timestamp` using the accelerometer, then corrects
+   * the prediction with odometry and the gyro.
+   *
+   * @param timestamp     Time of the readings. Must not go backwards.
+   * @param gyroAngle     Heading reported by the gyro.
+   * @param speeds        Robot relative speeds measured by odometry, averaged
+   *                      since the previous update.
+   * @param xAcceleration Robot relative acceleration from the gyro.
+   * @param yAcceleration Robot relative acceleration from the gyro.
+   *
+   * @return The estimated pose.
+   */
+  frc::Pose2d update(units::second_t timestamp,
+                     const frc::Rotation2d &gyroAngle,
+                     const frc::ChassisSpeeds &speeds,
+                     units::meters_per_second_squared_t xAcceleration,
+                     units::meters_per_second_squared_t yAcceleration);
+
+  /**
+   * Corrects the estimate with a vision pose. The pose is moved forward to
+   * the newest update by how far odometry says the robot moved since it was
+   * captured.
+   *
+   * @param visionPose The estimated position of the robot from vision.
+   * @param timestamp  Time the camera frame was captured.
+   *
+   * @return False if the measurement is older than the recorded odometry and
+   *         was ignored.
+   */
+  bool addVisionMeasurement(const frc::Pose2d &visionPose,
+                            units::second_t timestamp);
+
+  /**
+   * Corrects the estimate with a vision pose, trusting it by its own
+   * standard deviations ordered X, Y, Theta (meters and radians).
+   */
+  bool addVisionMeasurement(const frc::Pose2d &visionPose,
+                            units::second_t timestamp,
+                            const wpi::array<double, 3> &stdDevs);
+
+  /**
+   * Sets the default standard deviations of vision measurements, ordered X,
+   * Y, Theta (meters and radians).
+   */
+  void setVisionStdDevs(const wpi::array<double, 3> &stdDevs);
+
+  /**
+   * Moves the estimate to a pose and forgets the recorded odometry.
+   *
+   * @param gyroAngle Heading reported by the gyro at `timestamp`.
+   * @param pose      Position to reset to.
+   * @param timestamp Time of `pose`.
+   */
+  void reset(const frc::Rotation2d &gyroAngle, const frc::Pose2d &pose,
+             units::second_t timestamp);
+
+  /**
+   * Returns the estimated position of the robot.
+   */
+  frc::Pose2d getPose() const;
+
+  /**
+   * Returns the estimated robot relative speeds.
+   */
+  frc::ChassisSpeeds getChassisSpeeds() const;
+
+  const State &getState() const { return state; }
+  const Covariance &getCovariance() const { return covariance; }
+
+  /**
+   * Returns the covariance of the estimated X, Y and heading.
+   */
+  Eigen::Matrix3d getPoseCovariance() const {
+    return covariance.topLeftCorner<3, 3>();
+  }
+
+private:
+  /**
+   * Applies a linear measurement of the state with the Joseph form update,
+   * which keeps the covariance symmetric and positive definite.
+   *
+   * @param measurement      Maps the state to the measurement.
+   * @param residual         Measurement less its prediction.
+   * @param measurementNoise Covariance of the measurement.
+   */
+  template <int Rows>
+  void correct(const Eigen::Matrix<double, Rows, kStates> &measurement,
+               const Eigen::Matrix<double, Rows, 1> &residual,
+               const Eigen::Matrix<double, Rows, Rows> &measurementNoise);
+
+  KalmanPoseEstimatorHelper::NoiseConfig noise;
+  Eigen::Matrix<double, 3, 3> odometryNoise;
+  Eigen::Matrix<double, 3, 3> visionNoise;
+
+  State state;
+  Covariance covariance;
+  units::second_t timestamp;
+
+  /**
+   * Pose from odometry and the gyro alone. Vision is compensated by how far
+   * it moved since a frame was captured, which corrections never disturb.
+   */
+  frc::Pose2d odometryPose;
+  frc::Rotation2d lastGyroAngle;
+
+  /**
+   * Odometry poses recorded by `update()`. 256 entries covers over 1 s of
+   * updates from a 250 Hz odometry thread.
+   */
+  PoseHistory odometryHistory{256};
+};
+} // namespace rmb
@@ -0,0 +1,140 @@
+#include "rmb/drive/PathCache.h"
+
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <system_error>
+
+#include <frc/Filesystem.h>
+#include <frc/Timer.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+
+namespace rmb {
+
+PathCache::PathCache(units::second_t samplePeriod)
+    : samplePeriod(samplePeriod) {
+  std::filesystem::path pathDirectory =
+      std::filesystem::path(frc::filesystem::GetDeployDirectory()) /
+      "pathplanner" / "paths";
+
+  std::error_code error;
+  for (const std::filesystem::directory_entry &file :
+       std::filesystem::directory_iterator(pathDirectory, error)) {
+    if (file.path().extension() == ".path") {
+      entries.emplace(file.path().stem().string(), std::make_unique<Entry>());
+    }
+  }
+
+  loadThread = std::thread([this]() { loadAll(); });
+}
+
+PathCache::~PathCache() {
+  stopLoading.store(true, std::memory_order_relaxed);
+  loadThread.join();
+}
+
+std::shared_ptr<pathplanner::PathPlannerPath>
+PathCache::getPath(const std::string &name) const {
+  const Entry *entry = getLoadedEntry(name);
+  return entry ? entry->path : nullptr;
+}
+
+std::shared_ptr<const SampledTrajectory>
+PathCache::getTrajectory(const std::string &name) const {
+  const Entry *entry = getLoadedEntry(name);
+  return entry ? entry->trajectory : nullptr;
+}
+
+bool PathCache::isLoaded(const std::string &name) const {
+  auto iterator = entries.find(name);
+  return iterator != entries.end() &&
+         iterator->second->ready.load(std::memory_order_acquire);
+}
+
+std::vector<std::string> PathCache::getNames() const {
+  std::vector<std::string> names;
+  names.reserve(entries.size());
+  for (const auto &[name, entry] : entries) {
+    names.push_back(name);
+  }
+  return names;
+}
+
+std::vector<std::pair<std::string, units::second_t>>
+PathCache::getLoadTimes() const {
+  std::lock_guard<std::mutex> lock(loadTimesMutex);
+  return loadTimes;
+}
+
+const PathCache::Entry *
+PathCache::getLoadedEntry(const std::string &name) const {
+  auto iterator = entries.find(name);
+  if (iterator == entries.end()) {
+    return nullptr;
+  }
+
+  // Loads the path here unless another thread already has, in which case
+  // this only waits for that one path.
+  Entry &entry = *iterator->second;
+  std::call_once(entry.loaded, [this, &name, &entry]() { load(name, entry); });
+  return &entry;
+}
+
+void PathCache::load(const std::string &name, Entry &entry) const {
+  units::second_t startTime = frc::Timer::GetFPGATimestamp();
+
+  // A malformed path file must not take down the loading thread.
+  try {
+    entry.path = pathplanner::PathPlannerPath::fromPathFile(name);
+
+    std::filesystem::path deployDirectory =
+        frc::filesystem::GetDeployDirectory();
+    std::filesystem::path source =
+        deployDirectory / "pathplanner" / "paths" / (name + ".path");
+    std::filesystem::path pregenerated =
+        deployDirectory / "trajectories" / (name + ".traj");
+
+    // Only use a pre-generated trajectory made from this version of the path.
+    std::error_code error;
+    std::optional<uint64_t> sourceHash =
+        SampledTrajectory::hashFile(source.string());
+    if (sourceHash && std::filesystem::exists(pregenerated, error)) {
+      entry.trajectory =
+          SampledTrajectory::load(pregenerated.string(), sourceHash);
+    }
+
+    if (!entry.trajectory) {
+      entry.trajectory = std::make_shared<const SampledTrajectory>(
+          entry.path->getTrajectory(
+              frc::ChassisSpeeds(),
+              entry.path->getPreviewStartingHolonomicPose().Rotation()),
+          samplePeriod);
+    }
+  } catch (const std::exception &exception) {
+    std::cout << "Error: could not load path " << name << ": "
+              << exception.what() << std::endl;
+    entry.path = nullptr;
+    entry.trajectory = nullptr;
+  }
+
+  units::second_t loadTime = frc::Timer::GetFPGATimestamp() - startTime;
+
+  std::lock_guard<std::mutex> lock(loadTimesMutex);
+  loadTimes.emplace_back(name, loadTime);
+  entry.ready.store(true, std::memory_order_release);
+  loadedCount.fetch_add(1, std::memory_order_release);
+}
+
+void PathCache::loadAll() {
+  for (auto &[name, entry] : entries) {
+    if (stopLoading.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    std::call_once(entry->loaded,
+                   [this, &name, &entry]() { load(name, *entry); });
+  }
+}
+
+} // namespace rmb
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <pathplanner/lib/path/PathPlannerPath.h>
+
+#include "rmb/drive/SampledTrajectory.h"
+#include "units/time.h"
+
+namespace rmb {
+
+/**
+ * Loads every PathPlanner path in the deploy directory on a background
+ * thread and serves them by name.
+ *
+ * Constructing the cache only lists the deploy `pathplanner/paths`
+ * directory, so it does not stall robot startup. Each path is then parsed and
+ * its trajectory pre-generated in the background. Asking for a path that has
+ * not been loaded yet loads it right away on the calling thread (or waits for
+ * the background thread if it is already loading that path) without waiting
+ * on any other path.
+ */
+class PathCache {
+public:
+  PathCache(const PathCache &) = delete;
+  PathCache(PathCache &&) = delete;
+
+  /**
+   * Constructs a PathCache and starts loading paths in the background.
+   *
+   * @param samplePeriod Time between samples of the pre-generated
+   *                     trajectories.
+   */
+  explicit PathCache(units::second_t samplePeriod = 5_ms);
+
+  /**
+   * Stops loading paths, waiting for the path being loaded to finish.
+   */
+  ~PathCache();
+
+  /**
+   * Returns a path by name, loading it first if needed.
+   *
+   * @param name Name of the path file without the `.path` extension.
+   *
+   * @return The path, or nullptr if there is no path with that name or it
+   *         could not be parsed.
+   */
+  std::shared_ptr<pathplanner::PathPlannerPath>
+  getPath(const std::string &name) const;
+
+  /**
+   * Returns the pre-generated trajectory of a path by name, loading it first
+   * if needed. The trajectory starts at rest facing the path's preview
+   * starting rotation. A matching file in the deploy `trajectories`
+   * directory written by `SampledTrajectory::pregeneratePathPlannerPaths()`
+   * is used instead of generating it when one exists and was generated from
+   * the current version of the path.
+   *
+   * @param name Name of the path file without the `.path` extension.
+   *
+   * @return The trajectory, or nullptr if there is no path with that name
+   *         or it could not be parsed.
+   */
+  std::shared_ptr<const SampledTrajectory>
+  getTrajectory(const std::string &name) const;
+
+  /**
+   * Returns whether a path has finished loading.
+   */
+  bool isLoaded(const std::string &name) const;
+
+  /**
+   * Returns whether every path has finished loading.
+   */
+  bool isFullyLoaded() const {
+    return loadedCount.load(std::memory_order_acquire) == entries.size();
+  }
+
+  /**
+   * Returns the names of every path in the cache.
+   */
+  std::vector<std::string> getNames() const;
+
+  /**
+   * Returns how long each path that has finished loading took to parse and
+   * generate, in the order they finished.
+   */
+  std::vector<std::pair<std::string, units::second_t>> getLoadTimes() const;
+
+private:
+  struct Entry {
+    std::once_flag loaded;
+    std::atomic<bool> ready = false;
+    std::shared_ptr<pathplanner::PathPlannerPath> path;
+    std::shared_ptr<const SampledTrajectory> trajectory;
+  };
+
+  /**
+   * Returns the entry for a path after making sure it has been loaded, or
+   * nullptr if there is no such path.
+   */
+  const Entry *getLoadedEntry(const std::string &name) const;
+
+  void load(const std::string &name, Entry &entry) const;
+
+  void loadAll();
+
+  units::second_t samplePeriod;
+
+  /**
+   * Filled once by the constructor and never modified afterwards, so lookups
+   * do not need to lock.
+   */
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries;
+
+  mutable std::atomic<size_t> loadedCount = 0;
+
+  mutable std::mutex loadTimesMutex;
+  mutable std::vector<std::pair<std::string, units::second_t>> loadTimes;
+
+  std::atomic<bool> stopLoading = false;
+  std::thread loadThread;
+};
+} // namespace rmb
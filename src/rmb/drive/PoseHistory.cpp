@@ -0,0 +1,100 @@
+#include "rmb/drive/PoseHistory.h"
+
+#include <algorithm>
+
+#include <frc/geometry/Twist2d.h>
+
+namespace rmb {
+
+PoseHistory::PoseHistory(size_t capacity)
+    : entries(std::max<size_t>(capacity, 1)) {}
+
+void PoseHistory::record(const TimestampedPose &entry) {
+  if (count > 0) {
+    units::second_t newest = at(count - 1).timestamp;
+
+    if (entry.timestamp == newest) {
+      entries[(oldest + count - 1) % entries.size()] = entry;
+      return;
+    }
+
+    if (entry.timestamp < newest) {
+      clear();
+    }
+  }
+
+  if (count < entries.size()) {
+    entries[(oldest + count) % entries.size()] = entry;
+    count++;
+  } else {
+    entries[oldest] = entry;
+    oldest = (oldest + 1) % entries.size();
+  }
+}
+
+std::optional<TimestampedPose>
+PoseHistory::sample(units::second_t timestamp) const {
+  if (count == 0 || timestamp < at(0).timestamp) {
+    return std::nullopt;
+  }
+
+  if (timestamp >= at(count - 1).timestamp) {
+    return at(count - 1);
+  }
+
+  // Find the first entry after the timestamp. The checks above guarantee it
+  // is neither the first entry nor past the last.
+  size_t low = 1;
+  size_t high = count - 1;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (at(middle).timestamp <= timestamp) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  const TimestampedPose &before = at(low - 1);
+  const TimestampedPose &after = at(low);
+  double t = ((timestamp - before.timestamp) /
+              (after.timestamp - before.timestamp))
+                 .value();
+
+  // Interpolate along the constant curvature arc between the poses, which is
+  // how odometry assumes the robot moved between them.
+  frc::Twist2d twist = before.pose.Log(after.pose);
+  frc::Pose2d pose = before.pose.Exp(
+      frc::Twist2d{twist.dx * t, twist.dy * t, twist.dtheta * t});
+
+  frc::ChassisSpeeds chassisSpeeds{
+      before.chassisSpeeds.vx +
+          (after.chassisSpeeds.vx - before.chassisSpeeds.vx) * t,
+      before.chassisSpeeds.vy +
+          (after.chassisSpeeds.vy - before.chassisSpeeds.vy) * t,
+      before.chassisSpeeds.omega +
+          (after.chassisSpeeds.omega - before.chassisSpeeds.omega) * t};
+
+  return TimestampedPose{timestamp, pose, chassisSpeeds};
+}
+
+std::optional<TimestampedPose> PoseHistory::getLatest() const {
+  if (count == 0) {
+    return std::nullopt;
+  }
+  return at(count - 1);
+}
+
+std::optional<TimestampedPose> PoseHistory::getOldest() const {
+  if (count == 0) {
+    return std::nullopt;
+  }
+  return at(0);
+}
+
+void PoseHistory::clear() {
+  oldest = 0;
+  count = 0;
+}
+
+} // namespace rmb
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+
+#include "units/time.h"
+
+namespace rmb {
+
+/**
+ * Estimated pose and speeds of the robot at one point in time.
+ */
+struct TimestampedPose {
+  units::second_t timestamp = 0.0_s; /* <- FPGA time of the estimate. */
+  frc::Pose2d pose;                  /* <- Estimated position of the robot. */
+  frc::ChassisSpeeds chassisSpeeds;  /* <- Measured robot relative speeds. */
+};
+
+/**
+ * Fixed capacity record of recent pose estimates that can be queried at any
+ * time inside the recorded window.
+ *
+ * Entries are kept in a ring buffer allocated once at construction, so
+ * recording and querying never allocate. Queries binary search the entries by
+ * timestamp and interpolate between the two either side, which is what
+ * latency compensated consumers such as vision or shooting on the move need.
+ *
+ * This class is not synchronized. Users sharing it between threads must lock
+ * around it.
+ */
+class PoseHistory {
+public:
+  /**
+   * Constructs an empty PoseHistory.
+   *
+   * @param capacity Number of entries kept. Once full, recording an entry
+   *                 discards the oldest. Must be at least one.
+   */
+  explicit PoseHistory(size_t capacity);
+
+  /**
+   * Records an estimate. Estimates must be recorded in time order: one with
+   * the same timestamp as the newest entry replaces it, and one older than
+   * the newest entry clears the history first.
+   *
+   * @param entry The estimate to record.
+   */
+  void record(const TimestampedPose &entry);
+
+  /**
+   * Returns the estimate at a time, interpolated between the recorded
+   * estimates either side of it.
+   *
+   * @param timestamp FPGA time to look up.
+   *
+   * @return The estimate, the newest estimate if `timestamp` is after it, or
+   *         nothing if the history is empty or `timestamp` is before the
+   *         oldest estimate.
+   */
+  std::optional<TimestampedPose> sample(units::second_t timestamp) const;
+
+  /**
+   * Returns the newest estimate, or nothing if the history is empty.
+   */
+  std::optional<TimestampedPose> getLatest() const;
+
+  /**
+   * Returns the oldest estimate, or nothing if the history is empty.
+   */
+  std::optional<TimestampedPose> getOldest() const;
+
+  /**
+   * Discards every entry. Capacity is kept.
+   */
+  void clear();
+
+  size_t size() const { return count; }
+
+  size_t capacity() const { return entries.size(); }
+
+private:
+  /**
+   * Returns the `i`th oldest entry.
+   */
+  const TimestampedPose &at(size_t i) const {
+    return entries[(oldest + i) % entries.size()];
+  }
+
+  std::vector<TimestampedPose> entries;
+  size_t oldest = 0;
+  size_t count = 0;
+};
+} // namespace rmb
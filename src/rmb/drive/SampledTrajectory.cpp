@@ -0,0 +1,426 @@
+#include "rmb/drive/SampledTrajectory.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <system_error>
+
+#include <frc/Filesystem.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+
+#include <pathplanner/lib/path/PathPlannerPath.h>
+
+#include <wpi/MappedFileRegion.h>
+#include <wpi/fs.h>
+
+#include "units/math.h"
+
+namespace rmb {
+
+namespace {
+
+/**
+ * Start of every trajectory file. The columns follow immediately, each
+ * `count` doubles long, in the order of `SampledTrajectory::Column`.
+ */
+struct TrajectoryFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t columns;
+  uint32_t reserved;
+  uint64_t count;
+  double period;
+  double totalTime;
+  uint64_t sourceHash; /* <- Of the file generated from, or 0. */
+};
+
+constexpr char kTrajectoryFileMagic[4] = {'R', 'M', 'B', 'T'};
+
+/**
+ * Increment whenever the layout of trajectory files changes.
+ */
+constexpr uint32_t kTrajectoryFileVersion = 2;
+
+static_assert(sizeof(TrajectoryFileHeader) % alignof(double) == 0,
+              "Columns must stay aligned after the header");
+static_assert(std::endian::native == std::endian::little,
+              "Trajectory files are stored little endian");
+
+/**
+ * Returns `angle` shifted by whole turns to be as close as possible to
+ * `previous`, so interpolating between the two never goes the long way
+ * around.
+ */
+double unwrap(double angle, double previous) {
+  return previous + std::remainder(angle - previous, 2.0 * std::numbers::pi);
+}
+
+size_t getSampleCount(units::second_t totalTime, units::second_t period) {
+  // One sample at every multiple of the period plus one at the very end.
+  return static_cast<size_t>(std::ceil((totalTime / period).value())) + 1;
+}
+
+units::second_t getSampleTime(size_t index, units::second_t period,
+                              units::second_t totalTime) {
+  return units::math::min(period * static_cast<double>(index), totalTime);
+}
+
+} // namespace
+
+SampledTrajectory::SampledTrajectory(const frc::Trajectory &trajectory,
+                                     units::second_t period)
+    : period(period) {
+  resample({trajectory});
+}
+
+SampledTrajectory::SampledTrajectory(
+    const std::vector<frc::Trajectory> &trajectoryGroup, units::second_t period)
+    : period(period) {
+  resample(trajectoryGroup);
+}
+
+SampledTrajectory::SampledTrajectory(
+    const pathplanner::PathPlannerTrajectory &trajectory,
+    units::second_t period)
+    : period(period) {
+  const std::vector<pathplanner::PathPlannerTrajectory::State> &states =
+      trajectory.getStates();
+
+  if (states.empty()) {
+    return;
+  }
+
+  totalTime = states.back().time;
+  double *data = allocate(getSampleCount(totalTime, period));
+
+  size_t state = 0;
+  for (size_t i = 0; i < count; i++) {
+    units::second_t t = getSampleTime(i, period, totalTime);
+
+    // Samples are taken in order, so the states only ever move forward.
+    while (state + 2 < states.size() && states[state + 1].time < t) {
+      state++;
+    }
+
+    const pathplanner::PathPlannerTrajectory::State &start = states[state];
+    const pathplanner::PathPlannerTrajectory::State &end =
+        states[std::min(state + 1, states.size() - 1)];
+
+    double fraction = 0.0;
+    if (end.time > start.time) {
+      fraction = std::clamp(((t - start.time) / (end.time - start.time))(),
+                            0.0, 1.0);
+    }
+
+    auto lerp = [fraction](double a, double b) {
+      return a + (b - a) * fraction;
+    };
+    auto lerpAngle = [fraction](const frc::Rotation2d &a,
+                                const frc::Rotation2d &b) {
+      return a.Radians()() + (b - a).Radians()() * fraction;
+    };
+
+    double heading = lerpAngle(start.heading, end.heading);
+    double rotation =
+        lerpAngle(start.targetHolonomicRotation, end.targetHolonomicRotation);
+
+    if (i > 0) {
+      heading = unwrap(heading, data[kHeading * count + i - 1]);
+      rotation = unwrap(rotation, data[kRotation * count + i - 1]);
+    }
+
+    data[kX * count + i] = lerp(start.position.X()(), end.position.X()());
+    data[kY * count + i] = lerp(start.position.Y()(), end.position.Y()());
+    data[kHeading * count + i] = heading;
+    data[kVelocity * count + i] = lerp(start.velocity(), end.velocity());
+    data[kAcceleration * count + i] =
+        lerp(start.acceleration(), end.acceleration());
+    data[kCurvature * count + i] = lerp(start.curvature(), end.curvature());
+    data[kRotation * count + i] = rotation;
+  }
+}
+
+SampledTrajectory::SampledTrajectory(std::shared_ptr<const double> values,
+                                     size_t count, units::second_t period,
+                                     units::second_t totalTime)
+    : period(period), totalTime(totalTime), count(count),
+      values(std::move(values)) {}
+
+void SampledTrajectory::resample(
+    const std::vector<frc::Trajectory> &trajectoryGroup) {
+  totalTime = 0.0_s;
+  for (const frc::Trajectory &trajectory : trajectoryGroup) {
+    totalTime += trajectory.TotalTime();
+  }
+
+  if (trajectoryGroup.empty()) {
+    return;
+  }
+
+  double *data = allocate(getSampleCount(totalTime, period));
+
+  size_t segment = 0;
+  units::second_t segmentStart = 0.0_s;
+
+  for (size_t i = 0; i < count; i++) {
+    units::second_t t = getSampleTime(i, period, totalTime);
+
+    // Samples are taken in order, so the segment only ever moves forward.
+    while (segment + 1 < trajectoryGroup.size() &&
+           t > segmentStart + trajectoryGroup[segment].TotalTime()) {
+      segmentStart += trajectoryGroup[segment].TotalTime();
+      segment++;
+    }
+
+    frc::Trajectory::State state =
+        trajectoryGroup[segment].Sample(t - segmentStart);
+
+    double heading = state.pose.Rotation().Radians()();
+    if (i > 0) {
+      heading = unwrap(heading, data[kHeading * count + i - 1]);
+    }
+
+    data[kX * count + i] = state.pose.X()();
+    data[kY * count + i] = state.pose.Y()();
+    data[kHeading * count + i] = heading;
+    data[kVelocity * count + i] = state.velocity();
+    data[kAcceleration * count + i] = state.acceleration();
+    data[kCurvature * count + i] = state.curvature();
+  }
+
+  // Hold the final heading like frc2::SwerveControllerCommand does.
+  std::fill_n(data + kRotation * count, count,
+              data[kHeading * count + count - 1]);
+}
+
+double *SampledTrajectory::allocate(size_t newCount) {
+  auto buffer = std::make_shared<std::vector<double>>(newCount * kNumColumns);
+  count = newCount;
+  values = std::shared_ptr<const double>(buffer, buffer->data());
+  return buffer->data();
+}
+
+double SampledTrajectory::interpolate(Column column, units::second_t t) const {
+  t = std::clamp(t, 0.0_s, totalTime);
+
+  double position = (t / period).value();
+  size_t index = std::min(static_cast<size_t>(position), count - 1);
+  size_t next = std::min(index + 1, count - 1);
+
+  // The final interval ends at the total time and may be shorter than the
+  // period.
+  units::second_t start = period * static_cast<double>(index);
+  units::second_t span = units::math::min(period, totalTime - start);
+  double fraction = span > 0.0_s ? ((t - start) / span).value() : 0.0;
+
+  const double *samples = this->column(column);
+  return samples[index] + (samples[next] - samples[index]) * fraction;
+}
+
+frc::Trajectory::State SampledTrajectory::sample(units::second_t t) const {
+  if (count == 0) {
+    return frc::Trajectory::State{};
+  }
+
+  return frc::Trajectory::State{
+      std::clamp(t, 0.0_s, totalTime),
+      units::meters_per_second_t(interpolate(kVelocity, t)),
+      units::meters_per_second_squared_t(interpolate(kAcceleration, t)),
+      frc::Pose2d(units::meter_t(interpolate(kX, t)),
+                  units::meter_t(interpolate(kY, t)),
+                  units::radian_t(interpolate(kHeading, t))),
+      units::curvature_t(interpolate(kCurvature, t))};
+}
+
+frc::Rotation2d SampledTrajectory::getTargetRotation(units::second_t t) const {
+  if (count == 0) {
+    return frc::Rotation2d();
+  }
+
+  return frc::Rotation2d(units::radian_t(interpolate(kRotation, t)));
+}
+
+frc::Pose2d SampledTrajectory::getInitialPose() const {
+  return sample(0.0_s).pose;
+}
+
+frc::Pose2d SampledTrajectory::getFinalPose() const {
+  return sample(totalTime).pose;
+}
+
+bool SampledTrajectory::save(const std::string &filename,
+                             uint64_t sourceHash) const {
+  TrajectoryFileHeader header{};
+  std::memcpy(header.magic, kTrajectoryFileMagic, sizeof(header.magic));
+  header.version = kTrajectoryFileVersion;
+  header.columns = kNumColumns;
+  header.count = count;
+  header.period = period();
+  header.totalTime = totalTime();
+  header.sourceHash = sourceHash;
+
+  // Written next to the target and renamed over it, so a mapping of the old
+  // file held by `load()` is never truncated under its reader.
+  std::string temporaryFilename = filename + ".tmp";
+
+  std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if (count > 0) {
+    file.write(reinterpret_cast<const char *>(values.get()),
+               count * kNumColumns * sizeof(double));
+  }
+  file.close();
+
+  std::error_code error;
+  if (!file.good()) {
+    std::filesystem::remove(temporaryFilename, error);
+    return false;
+  }
+
+  std::filesystem::rename(temporaryFilename, filename, error);
+  if (error) {
+    std::filesystem::remove(temporaryFilename, error);
+    return false;
+  }
+
+  return true;
+}
+
+std::shared_ptr<const SampledTrajectory>
+SampledTrajectory::load(const std::string &filename,
+                        std::optional<uint64_t> sourceHash) {
+  std::error_code error;
+  uint64_t length = fs::file_size(filename, error);
+  if (error || length < sizeof(TrajectoryFileHeader)) {
+    std::cout << "Error: could not read trajectory " << filename << std::endl;
+    return nullptr;
+  }
+
+  fs::file_t file = fs::OpenFileForRead(filename, error);
+  if (error) {
+    std::cout << "Error: could not open trajectory " << filename << std::endl;
+    return nullptr;
+  }
+
+  // The mapping stays valid after the file is closed.
+  auto region = std::make_shared<wpi::MappedFileRegion>(
+      file, length, 0, wpi::MappedFileRegion::kReadOnly, error);
+  fs::CloseFile(file);
+
+  if (error || !*region) {
+    std::cout << "Error: could not map trajectory " << filename << std::endl;
+    return nullptr;
+  }
+
+  TrajectoryFileHeader header;
+  std::memcpy(&header, region->const_data(), sizeof(header));
+
+  bool compatible =
+      std::memcmp(header.magic, kTrajectoryFileMagic, sizeof(header.magic)) ==
+          0 &&
+      header.version == kTrajectoryFileVersion &&
+      header.columns == kNumColumns && header.period > 0.0 &&
+      length == sizeof(header) + header.count * kNumColumns * sizeof(double);
+
+  if (!compatible) {
+    std::cout << "Error: " << filename << " is not a compatible trajectory file"
+              << std::endl;
+    return nullptr;
+  }
+
+  if (sourceHash && header.sourceHash != *sourceHash) {
+    std::cout << filename << " is out of date with its path" << std::endl;
+    return nullptr;
+  }
+
+  // Alias the mapping so it is unmapped along with the last trajectory using
+  // it.
+  std::shared_ptr<const double> values(
+      region,
+      reinterpret_cast<const double *>(region->const_data() + sizeof(header)));
+
+  return std::shared_ptr<const SampledTrajectory>(new SampledTrajectory(
+      std::move(values), header.count, units::second_t(header.period),
+      units::second_t(header.totalTime)));
+}
+
+std::optional<uint64_t>
+SampledTrajectory::hashFile(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+
+  // 64 bit FNV-1a. Path files are a few kilobytes, so this is cheap next to
+  // generating them.
+  uint64_t hash = 0xcbf29ce484222325;
+  char buffer[4096];
+  while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+    for (std::streamsize i = 0; i < file.gcount(); i++) {
+      hash ^= static_cast<unsigned char>(buffer[i]);
+      hash *= 0x100000001b3;
+    }
+  }
+
+  return hash;
+}
+
+size_t SampledTrajectory::pregeneratePathPlannerPaths(
+    const std::string &outputDirectory, units::second_t period) {
+  std::filesystem::path pathDirectory =
+      std::filesystem::path(frc::filesystem::GetDeployDirectory()) /
+      "pathplanner" / "paths";
+
+  std::error_code error;
+  std::filesystem::create_directories(outputDirectory, error);
+
+  size_t written = 0;
+  for (const std::filesystem::directory_entry &entry :
+       std::filesystem::directory_iterator(pathDirectory, error)) {
+    if (entry.path().extension() != ".path") {
+      continue;
+    }
+
+    std::string name = entry.path().stem().string();
+
+    // Skip malformed path files rather than failing the rest.
+    std::optional<SampledTrajectory> trajectory;
+    try {
+      std::shared_ptr<pathplanner::PathPlannerPath> path =
+          pathplanner::PathPlannerPath::fromPathFile(name);
+
+      trajectory.emplace(
+          path->getTrajectory(
+              frc::ChassisSpeeds(),
+              path->getPreviewStartingHolonomicPose().Rotation()),
+          period);
+    } catch (const std::exception &exception) {
+      std::cout << "Error: could not generate path " << name << ": "
+                << exception.what() << std::endl;
+      continue;
+    }
+
+    std::filesystem::path filename =
+        std::filesystem::path(outputDirectory) / (name + ".traj");
+
+    if (trajectory->save(filename.string(),
+                         hashFile(entry.path().string()).value_or(0))) {
+      written++;
+    } else {
+      std::cout << "Error: could not write trajectory " << filename
+                << std::endl;
+    }
+  }
+
+  return written;
+}
+
+} // namespace rmb
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Rotation2d.h>
+#include <frc/trajectory/Trajectory.h>
+
+#include <pathplanner/lib/path/PathPlannerTrajectory.h>
+
+#include "units/time.h"
+
+namespace rmb {
+
+/**
+ * A trajectory resampled once at a fixed time step into contiguous arrays so
+ * it can be sampled in constant time.
+ *
+ * `frc::Trajectory::Sample()` binary searches its states on every call. This
+ * instead does that work when the trajectory is loaded: looking up a time is
+ * a single index calculation followed by linear interpolation between two
+ * neighbouring entries. Each field is kept in its own array so a lookup only
+ * touches the few cache lines it reads.
+ *
+ * The arrays can also be written to a binary file with `save()` ahead of
+ * time and memory mapped back with `load()`, so following a pre-generated
+ * path needs no parsing or generation on the robot.
+ */
+class SampledTrajectory {
+public:
+  /**
+   * Resamples a single trajectory. The target rotation is held at the
+   * trajectory's final heading like `frc2::SwerveControllerCommand` does.
+   *
+   * @param trajectory The trajectory to resample.
+   * @param period     Time between samples. Must be positive. Smaller
+   *                   periods follow the original trajectory more closely at
+   *                   the cost of memory.
+   */
+  explicit SampledTrajectory(const frc::Trajectory &trajectory,
+                             units::second_t period = 5_ms);
+
+  /**
+   * Resamples trajectories that are followed back to back into one table.
+   * Each trajectory starts as soon as the previous one ends.
+   *
+   * @param trajectoryGroup The trajectories to resample, in order.
+   * @param period          Time between samples.
+   */
+  explicit SampledTrajectory(
+      const std::vector<frc::Trajectory> &trajectoryGroup,
+      units::second_t period = 5_ms);
+
+  /**
+   * Resamples a generated PathPlanner trajectory, including its holonomic
+   * rotation targets.
+   *
+   * @param trajectory The trajectory to resample.
+   * @param period     Time between samples.
+   */
+  explicit SampledTrajectory(
+      const pathplanner::PathPlannerTrajectory &trajectory,
+      units::second_t period = 5_ms);
+
+  /**
+   * Returns the state of the trajectory at a time.
+   *
+   * @param t Time since the start of the trajectory. Times outside of the
+   *          trajectory are clamped to its start or end.
+   */
+  frc::Trajectory::State sample(units::second_t t) const;
+
+  /**
+   * Returns the rotation a holonomic drive should face at a time.
+   *
+   * @param t Time since the start of the trajectory.
+   */
+  frc::Rotation2d getTargetRotation(units::second_t t) const;
+
+  /**
+   * Returns the time it takes to follow the whole trajectory.
+   */
+  units::second_t getTotalTime() const { return totalTime; }
+
+  /**
+   * Returns the time between samples.
+   */
+  units::second_t getPeriod() const { return period; }
+
+  /**
+   * Returns the pose at the start of the trajectory.
+   */
+  frc::Pose2d getInitialPose() const;
+
+  /**
+   * Returns the pose at the end of the trajectory.
+   */
+  frc::Pose2d getFinalPose() const;
+
+  /**
+   * Returns the number of samples stored.
+   */
+  size_t size() const { return count; }
+
+  //------------------
+  // Trajectory Files
+  //------------------
+
+  /**
+   * Writes the trajectory to a binary file that can be read back by `load()`.
+   * The file is replaced in one step, so trajectories already loaded from it
+   * stay valid.
+   *
+   * @param filename   Path of the file to write.
+   * @param sourceHash Hash of the file the trajectory was generated from,
+   *                   from `hashFile()`, so `load()` can tell when it is out
+   *                   of date.
+   *
+   * @return Whether the file was written successfully.
+   */
+  bool save(const std::string &filename, uint64_t sourceHash = 0) const;
+
+  /**
+   * Memory maps a trajectory written by `save()`. The samples are read
+   * directly from the mapping rather than being copied or parsed.
+   *
+   * @param filename   Path of the file to read.
+   * @param sourceHash Current hash of the file the trajectory was generated
+   *                   from, or nothing to skip the check.
+   *
+   * @return The trajectory, or nullptr if the file could not be read, was
+   *         written by an incompatible version, or was generated from a
+   *         different version of its source.
+   */
+  static std::shared_ptr<const SampledTrajectory>
+  load(const std::string &filename,
+       std::optional<uint64_t> sourceHash = std::nullopt);
+
+  /**
+   * Hashes the contents of a file, such as the path a trajectory is
+   * generated from, for `save()` and `load()`.
+   *
+   * @return The hash, or nothing if the file could not be read.
+   */
+  static std::optional<uint64_t> hashFile(const std::string &filename);
+
+  /**
+   * Generates every PathPlanner path in the deploy directory and writes each
+   * one to `<outputDirectory>/<name>.traj`. Paths are generated starting at
+   * rest, facing their preview starting rotation.
+   *
+   * This is meant to be run on the desktop before deploying, from the
+   * project directory so the deploy directory is its `src/main/deploy`
+   * folder. The testbench's `generateTrajectories` Gradle task does this on
+   * every deploy. Paths that fail to parse or generate are reported and
+   * skipped.
+   *
+   * Each file records a hash of its path, so a file left over from an
+   * older version of the path is not used by `PathCache`.
+   *
+   * @param outputDirectory Directory to write trajectories to. Created if it
+   *                        does not exist.
+   * @param period          Time between samples.
+   *
+   * @return The number of trajectories written.
+   */
+  static size_t pregeneratePathPlannerPaths(const std::string &outputDirectory,
+                                            units::second_t period = 5_ms);
+
+private:
+  /**
+   * Order the fields are stored in, both in memory and in files.
+   */
+  enum Column : size_t {
+    kX = 0,           /* <- Meters. */
+    kY,               /* <- Meters. */
+    kHeading,         /* <- Radians, unwrapped. */
+    kVelocity,        /* <- Meters per second. */
+    kAcceleration,    /* <- Meters per second squared. */
+    kCurvature,       /* <- Radians per meter. */
+    kRotation,        /* <- Radians, unwrapped. */
+    kNumColumns
+  };
+
+  SampledTrajectory(std::shared_ptr<const double> values, size_t count,
+                    units::second_t period, units::second_t totalTime);
+
+  void resample(const std::vector<frc::Trajectory> &trajectoryGroup);
+
+  /**
+   * Allocates storage for `count` samples and returns it for writing.
+   */
+  double *allocate(size_t count);
+
+  const double *column(Column column) const {
+    return values.get() + column * count;
+  }
+
+  double interpolate(Column column, units::second_t t) const;
+
+  units::second_t period;
+  units::second_t totalTime = 0.0_s;
+  size_t count = 0;
+
+  /**
+   * Every column back to back. Points either into an owned buffer or into a
+   * memory mapped file, which the shared pointer keeps alive.
+   */
+  std::shared_ptr<const double> values;
+};
+} // namespace rmb
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 
 #include <units/angle.h>
 #include <units/velocity.h>
 
+#include <frc/Notifier.h>
+#include <frc/Timer.h>
 #include <frc/controller/HolonomicDriveController.h>
 #include <frc/estimator/SwerveDrivePoseEstimator.h>
 #include <frc/geometry/Rotation2d.h>
@@ -25,30 +31,107 @@
 #include "frc/geometry/Translation2d.h"
 #include "frc2/command/Commands.h"
 #include "networktables/DoubleArrayTopic.h"
+#include "networktables/NetworkTableInstance.h"
 #include "pathplanner/lib/commands/FollowPathHolonomic.h"
 #include "pathplanner/lib/path/PathConstraints.h"
 #include "pathplanner/lib/path/PathPlannerPath.h"
 #include "rmb/drive/BaseDrive.h"
+#include "rmb/drive/KalmanPoseEstimator.h"
+#include "rmb/drive/PoseHistory.h"
+#include "rmb/drive/SampledTrajectory.h"
 #include "rmb/drive/SwerveModule.h"
+#include "rmb/drive/SwerveSetpointGenerator.h"
+#include "rmb/drive/SwerveTelemetry.h"
+#include "rmb/drive/VisionGate.h"
+#include "rmb/pathfinding/PathfindingService.h"
+#include "units/acceleration.h"
 #include "units/angular_velocity.h"
 
 #include <frc2/command/Command.h>
 #include <frc2/command/CommandPtr.h>
 
 #include "networktables/DoubleTopic.h"
+#include "networktables/IntegerTopic.h"
+#include "units/frequency.h"
 #include "units/time.h"
 
 #include <rmb/sensors/gyro.h>
+#include <rmb/util/DataLogRecorder.h>
+#include <rmb/util/Profiler.h>
+#include <rmb/util/SPSCQueue.h>
+#include <rmb/util/SeqLock.h>
 #include <vector>
 
 namespace rmb {
 
+/**
+ * Readings from every module of a swerve drive and its gyro captured together
+ * by `SwerveDrive::sample()`.
+ *
+ * @tparam NumModules Number fo swerve modules on the drivetrain.
+ */
+template <size_t NumModules> struct SwerveDriveSnapshot {
+  units::second_t timestamp = 0.0_s; /* <- FPGA time the sample was taken. */
+  frc::Rotation2d heading;           /* <- Heading reported by the gyro. */
+
+  // Robot relative acceleration reported by the gyro.
+  units::meters_per_second_squared_t xAcceleration = 0.0_mps_sq;
+  units::meters_per_second_squared_t yAcceleration = 0.0_mps_sq;
+
+  std::array<frc::SwerveModuleState, NumModules> states;       /* <- Measured */
+  std::array<frc::SwerveModulePosition, NumModules> positions; /* <- Measured */
+  std::array<frc::SwerveModuleState, NumModules> targetStates; /* <- Targets */
+};
+
+/**
+ * Module positions and gyro heading recorded by the odometry thread of a
+ * `SwerveDrive`.
+ *
+ * @tparam NumModules Number fo swerve modules on the drivetrain.
+ */
+template <size_t NumModules> struct SwerveOdometrySample {
+  units::second_t timestamp = 0.0_s; /* <- FPGA time the sample was taken. */
+  frc::Rotation2d heading;           /* <- Heading reported by the gyro. */
+  std::array<frc::SwerveModulePosition, NumModules> positions;
+
+  // Robot relative acceleration reported by the gyro.
+  units::meters_per_second_squared_t xAcceleration = 0.0_mps_sq;
+  units::meters_per_second_squared_t yAcceleration = 0.0_mps_sq;
+};
+
+/**
+ * Output of a `SwerveDrive` pose estimator published after every pose update.
+ */
+struct SwerveDrivePoseEstimate {
+  frc::Pose2d pose;                  /* <- Estimated position of the robot. */
+  units::second_t timestamp = 0.0_s; /* <- FPGA time of the newest odometry. */
+  frc::ChassisSpeeds chassisSpeeds;  /* <- Measured robot relative speeds. */
+};
+
+/**
+ * Where a `SwerveDrive` publishes to and reads the time from. The defaults are
+ * the robot's. Simulations running several drives at once give each its own
+ * so they share no state.
+ */
+struct SwerveDriveEnvironment {
+  /** Instance for telemetry and vision. */
+  nt::NetworkTableInstance ntInstance = nt::NetworkTableInstance::GetDefault();
+
+  /** Timestamps samples and setpoints. Empty uses the FPGA clock. */
+  std::function<units::second_t()> clock;
+};
+
 /**
  * Class to manage most aspects of a swerve drivetrain from basic teleop
  * drive funtions to odometry and full path following for both WPIL
  ib and
  * PathPlanner trajectories.
  *
+ * Module states, positions and the heading are read from the snapshot taken
+ * by `sample()`, so it must be called at the start of every robot loop before
+ * driving, updating the pose or reading module states. A snapshot older than
+ * one loop is reported once on the console.
+ *
  * @tparam NumModules Number fo swerve modules on the drivetrain.
  */
 template <size_t NumModules> class SwerveDrive : public BaseDrive {
@@ -64,18 +147,21 @@ public:
    * @param gyro                Monitors the robots heading for odometry.
    * @param holonomicController Feedbakc controller for keeping the robot on
    * path.
-   * @param visionTable         Path to the NetworkTables table for listening
-   *                            for vision updates.
+   * @param cameraTables        Paths to the NetworkTables table of each
+   *                            camera publishing vision updates. See
+   *                            `BaseDrive` for the table layout.
    * @param maxModuleSpeed      Maximum speed any module can turn
    * @param initialPose         Starting position of the robot for odometry.
+   * @param environment         NetworkTables instance and clock to use.
    *
    */
   SwerveDrive(std::array<SwerveModule, NumModules> modules,
               std::shared_ptr<const rmb::Gyro> gyro,
               frc::HolonomicDriveController holonomicController,
-              std::string visionTable,
+              const std::vector<std::string> &cameraTables,
               units::meters_per_second_t maxModuleSpeed,
-              const frc::Pose2d &initialPose = frc::Pose2d());
+              const frc::Pose2d &initialPose = frc::Pose2d(),
+              const SwerveDriveEnvironment &environment = {});
 
   /**
    * Constructs a SwerveDrive object that **does not** automatically
@@ -87,15 +173,34 @@ public:
    *                            path.
    * @param maxModuleSpeed      Maximum speed any module can turn
    * @param initialPose         Starting position of the robot for odometry.
+   * @param environment         NetworkTables instance and clock to use.
    */
   SwerveDrive(std::array<SwerveModule, NumModules> modules,
               std::shared_ptr<const rmb::Gyro> gyro,
               frc::HolonomicDriveController holonomicController,
               units::meters_per_second_t maxModuleSpeed,
-              const frc::Pose2d &initialPose = frc::Pose2d());
+              const frc::Pose2d &initialPose = frc::Pose2d(),
+              const SwerveDriveEnvironment &environment = {});
 
   virtual ~SwerveDrive() = default;
 
+  /**
+   * Reads every module and the gyro exactly once and stores the result as the
+   * snapshot consumed by the drive, odometry and telemetry methods. Call this
+   * once at the start of every robot loop before driving or updating the
+   * pose so all of them work from the same, time aligned data.
+   *
+   * @return The newly captured snapshot.
+   */
+  const SwerveDriveSnapshot<NumModules> &sample();
+
+  /**
+   * Returns the snapshot captured by the most recent call to `sample()`.
+   */
+  const SwerveDriveSnapshot<NumModules> &getSnapshot() const {
+    return snapshot;
+  }
+
   void driveCartesian(double xSpeed, double ySpeed, double zRotation,
                       bool fieldOriented);
 
@@ -106,8 +211,14 @@ public:
 
   void driveModuleStates(std::array<frc::SwerveModuleState, NumModules> states);
 
+  /**
+   * Returns the module states from the most recent snapshot.
+   */
   std::array<frc::SwerveModuleState, NumModules> getModuleStates() const;
 
+  /**
+   * Returns the module positions from the most recent snapshot.
+   */
   std::array<frc::SwerveModulePosition, NumModules> getModulePositions() const;
 
   const std::array<rmb::SwerveModule, NumModules> &getModules() const {
@@ -117,10 +228,32 @@ public:
   /**
    * Drives the robot via the speeds of the Chassis.
    *
+   * When setpoint limits are set the drive moves toward `chassisSpeeds` only
+   * as fast as the modules can accelerate and steer.
+   *
    * @param chassisSpeeds Desired speeds of the robot Chassis.
    */
   void driveChassisSpeeds(frc::ChassisSpeeds chassisSpeeds) override;
 
+  /**
+   * Limits how quickly `driveChassisSpeeds()` may change module commands.
+   * Paths and teleop steps are then followed with module states the hardware
+   * can actually reach instead of being applied instantly.
+   *
+   * @param limits Acceleration and steering limits of the modules.
+   */
+  void setSetpointLimits(const SwerveSetpointLimits &limits);
+
+  /**
+   * Removes the limits set by `setSetpointLimits()`.
+   */
+  void clearSetpointLimits();
+
+  /**
+   * Returns the setpoint most recently commanded by `driveChassisSpeeds()`.
+   */
+  const SwerveSetpoint<NumModules> &getSetpoint() const { return setpoint; }
+
   /**
    * Returns the speeds of the robot chassis.
    */
@@ -132,9 +265,35 @@ public:
 
   /**
    * Returns the current poition without modifying it.
+   *
+   * This never blocks and is safe to call from any thread. It returns the
+   * pose published by the most recent `updatePose()` or `resetPose()`.
    */
   frc::Pose2d getPose() const override;
 
+  /**
+   * Returns the pose, its timestamp and the chassis speeds published by the
+   * most recent `updatePose()` or `resetPose()`, all from the same update.
+   * This never blocks and is safe to call from any thread.
+   */
+  SwerveDrivePoseEstimate getPoseEstimate() const;
+
+  /**
+   * Returns the estimated pose and chassis speeds at a recent time,
+   * interpolated from the estimates recorded by each `updatePose()`. This
+   * never allocates and is safe to call from any thread.
+   *
+   * @param timestamp FPGA time to look up, such as when a camera frame was
+   *                  captured.
+   *
+   * @return The estimate, or nothing if `timestamp` is older than the
+   *         recorded history.
+   */
+  std::optional<TimestampedPose> getPoseAt(units::second_t timestamp) const;
+
+  /**
+   * Returns the module target states from the most recent snapshot.
+   */
   std::array<frc::SwerveModuleState, NumModules> getTargetModuleStates() const;
 
   /**
@@ -186,6 +345,62 @@ public:
    */
   void setVisionSTDevs(wpi::array<double, 3> standardDevs) override;
 
+  /**
+   * Estimates the pose with a `KalmanPoseEstimator` instead of
+   * `frc::SwerveDrivePoseEstimator`. It also fuses the acceleration
+   * reported by the gyro, so brief wheel slip costs less pose error. The
+   * estimate continues from the current pose. Every pose, vision and
+   * odometry thread method works the same with either estimator.
+   *
+   * Each `updatePose()` costs a fixed amount per odometry sample and vision
+   * measurement applied, both of which are bounded by their queues.
+   *
+   * @param noise Standard deviations of each input. The vision standard
+   *              deviations are replaced by those last given to
+   *              `setVisionSTDevs()`, if any.
+   */
+  void enableSensorFusion(
+      const KalmanPoseEstimatorHelper::NoiseConfig &noise = {});
+
+  /**
+   * Goes back to estimating the pose with `frc::SwerveDrivePoseEstimator`,
+   * continuing from the current pose.
+   */
+  void disableSensorFusion();
+
+  /**
+   * Returns whether `enableSensorFusion()` is in effect.
+   */
+  bool isSensorFusionEnabled() const {
+    std::lock_guard<std::mutex> lock(visionThreadMutex);
+    return kalmanEstimator.has_value();
+  }
+
+  /**
+   * Rejects vision measurements that disagree with the pose estimate by more
+   * than their uncertainty explains, and scales the standard deviations of
+   * the rest by tag distance, tag count and robot speed. Applies to camera
+   * measurements and `addVisionMeasurments()` alike. The counts of accepted
+   * and rejected measurements are published with the NetworkTables debug
+   * info.
+   *
+   * With sensor fusion enabled the gate uses the estimator's covariance,
+   * otherwise `VisionGateHelper::Config::estimateStdDevs`.
+   *
+   * @param config Gate and standard deviation settings.
+   */
+  void setVisionGate(const VisionGateHelper::Config &config);
+
+  /**
+   * Applies every vision measurement as received.
+   */
+  void clearVisionGate();
+
+  /**
+   * Returns the counts of the vision gate, or nothing if it is not set.
+   */
+  std::optional<VisionGateHelper::Statistics> getVisionGateStatistics() const;
+
   //----------------------
   // Trajectory Following
   //----------------------
@@ -210,6 +425,47 @@ public:
       frc::Trajectory trajectory,
       std::initializer_list<frc2::Subsystem *> driveRequirements) override;
 
+  /**
+   * Generates a command to follow a vector of WPILib Trajectories back to
+   * back. When a trajectory sample period is set, the whole group is
+   * resampled into a single table and followed by one command.
+   *
+   * @param trajectoryGroup   The vector of trajectories to follow.
+   * @param driveRequirements The subsystems required for driving the robot
+   *                          (ie. the one that contains this class)
+   *
+   * @return The command to follow a list of trajectories.
+   */
+  frc2::CommandPtr followWPILibTrajectoryGroup(
+      std::vector<frc::Trajectory> trajectoryGroup,
+      std::initializer_list<frc2::Subsystem *> driveRequirements) override;
+
+  /**
+   * Generates a command to follow a trajectory that has already been
+   * resampled. Looking up the target state each loop takes constant time.
+   *
+   * @param trajectory        The trajectory to follow.
+   * @param driveRequirements The subsystems required for driving the robot
+   *                          (ie. the one that contains this class)
+   *
+   * @return The command to follow a trajectory.
+   */
+  frc2::CommandPtr followSampledTrajectory(
+      std::shared_ptr<const SampledTrajectory> trajectory,
+      std::initializer_list<frc2::Subsystem *> driveRequirements);
+
+  /**
+   * Makes `followWPILibTrajectory()` and `followWPILibTrajectoryGroup()`
+   * resample their trajectories into a `SampledTrajectory` when the command
+   * is generated, so following them never searches the trajectory.
+   *
+   * @param period Time between samples. Zero follows trajectories directly
+   *               with a `frc2::SwerveControllerCommand` (the default).
+   */
+  void setTrajectorySamplePeriod(units::second_t period) {
+    trajectorySamplePeriod = period;
+  }
+
   // /**
   //  * Generates a command to follow PathPlanner Trajectory.
   //  *
@@ -227,35 +483,206 @@ public:
       frc::Pose2d targetPose, pathplanner::PathConstraints constraints,
       std::initializer_list<frc2::Subsystem *> driveRequirements);
 
+  /**
+   * Generates a command that plans a path to a pose with a
+   * `PathfindingService` and then follows it. Planning happens on the
+   * service's worker thread while the command waits, and repeated targets
+   * are served from its cache.
+   *
+   * @param pathfinder        Service to plan the path with. Must outlive the
+   *                          command.
+   * @param targetPose        Pose to drive to.
+   * @param driveRequirements The subsystems required for driving the robot
+   *                          (ie. the one that contains this class)
+   *
+   * @return The command to drive to the pose.
+   */
+  frc2::CommandPtr FollowGeneratedPPPath(
+      std::shared_ptr<PathfindingService> pathfinder, frc::Pose2d targetPose,
+      std::initializer_list<frc2::Subsystem *> driveRequirements);
+
+  /**
+   * Publishes the measurements, targets and errors of every module to the
+   * `swervedrive/modules` struct array topic. Call every loop: publishing is
+   * rate limited and skipped while nothing changes.
+   *
+   * @param openLoopVelocity Whether the modules are driven by power, in
+   *                         which case powers are published as targets and
+   *                         velocity errors are zero.
+   */
   void updateNTDebugInfo(bool openLoopVelocity = false);
 
+  /**
+   * Sets how often `updateNTDebugInfo()` publishes at most.
+   */
+  void setTelemetryRate(units::hertz_t rate) {
+    telemetry->setPeriod(1.0 / rate);
+  }
+
+  /**
+   * Sets how far any module value must move before `updateNTDebugInfo()`
+   * publishes it again.
+   */
+  void setTelemetryDeadband(double deadband) {
+    telemetry->setDeadband(deadband);
+  }
+
   void stop();
 
+  /**
+   * Starts recording every snapshot and pose estimate to a DataLog at full
+   * rate. Each `sample()` records the measured and target state of every
+   * module and the gyro heading, and each `updatePose()` records the
+   * estimated pose. Call during setup: adding the log entries allocates.
+   *
+   * @param recorder The recorder to write to, or nullptr to stop recording.
+   */
+  void setDataLogRecorder(std::shared_ptr<DataLogRecorder> recorder);
+
+  //------------------
+  // Odometry Thread
+  //------------------
+
+  /**
+   * Starts sampling module positions and the gyro heading on a dedicated
+   * thread at a higher rate than the robot loop. Samples are queued and
+   * applied to the pose estimator the next time `updatePose()` is called, so
+   * odometry integrates at the thread's rate rather than the loop's.
+   *
+   * The thread is run by an `frc::Notifier`, so it follows simulated time in
+   * desktop simulation.
+   *
+   * The drive's own module commands are serialized with the thread's reads.
+   * Motor controllers used by the modules must not be read or commanded from
+   * outside the drive while the thread runs, unless they are thread safe.
+   *
+   * @param frequency      Rate at which to sample the modules and gyro.
+   * @param refreshSignals Called before every sample to refresh batched
+   *                       sensor signals (such as
+   *                       `StatusSignalRegistry::refreshAll`). When given,
+   *                       the thread is the only place those signals should
+   *                       be refreshed from.
+   */
+  void startOdometryThread(units::hertz_t frequency = 250_Hz,
+                           std::function<void()> refreshSignals = nullptr);
+
+  /**
+   * Stops the odometry thread. `updatePose()` goes back to updating from the
+   * snapshot taken by `sample()`.
+   */
+  void stopOdometryThread();
+
+  /**
+   * Returns whether the odometry thread is running.
+   */
+  bool isOdometryThreadRunning() const { return odometryNotifier.has_value(); }
+
+  /**
+   * Returns the number of odometry samples dropped because `updatePose()`
+   * was not called often enough to drain the queue.
+   */
+  size_t getDroppedOdometrySamples() const {
+    return droppedOdometrySamples.load(std::memory_order_relaxed);
+  }
+
 private:
+  /**
+   * Returns the current time from the environment's clock.
+   */
+  units::second_t now() const {
+    return clock ? clock() : frc::Timer::GetFPGATimestamp();
+  }
+
+  /**
+   * Reports once if the snapshot is older than `kMaxSnapshotAge`, which
+   * means `sample()` was not called this loop.
+   */
+  void checkSnapshotAge() const;
+
+  /**
+   * Reads every module and the gyro without taking `sensorMutex`.
+   */
+  SwerveDriveSnapshot<NumModules> readSnapshot() const;
+
+  /**
+   * Body of the odometry thread.
+   */
+  void sampleOdometry();
+
+  /**
+   * Applies odometry samples, then vision measurements, to
+   * `kalmanEstimator`. Must hold `visionThreadMutex`.
+   *
+   * @param vision Measurements taken at the start of `updatePose()`.
+   *
+   * @return Timestamp of the newest odometry applied.
+   */
+  units::second_t updateSensorFusion(std::span<const VisionMeasurement> vision);
+
+  /**
+   * Passes a measurement through `visionGate`, if set, replacing its
+   * standard deviations with those it should be applied with. Must hold
+   * `visionThreadMutex`.
+   *
+   * @return False if the measurement was rejected.
+   */
+  bool gateVisionMeasurement(VisionMeasurement &measurement);
+
+  /**
+   * Returns the odometry readings of the most recent snapshot.
+   */
+  SwerveOdometrySample<NumModules> getSnapshotOdometry() const;
+
+  /**
+   * Applies one odometry sample to `kalmanEstimator`, using the motion of
+   * the modules since `lastFusedOdometry`.
+   */
+  void fuseOdometry(const SwerveOdometrySample<NumModules> &sample);
+
+  /**
+   * Rebuilds `openLoopInverseKinematics` and `largestModuleDistance` from the
+   * current module translations. Must be called whenever they change.
+   */
   void recomputeOpenloopInverseKinematicsMatrix();
 
+  /**
+   * Returns the translation of each module from the center of the robot.
+   */
+  static std::array<frc::Translation2d, NumModules>
+  getModuleTranslations(const std::array<SwerveModule, NumModules> &modules);
+
   //-----------------
   // Network Tables Debugging
   //-----------------
 
-  // std::array<nt::DoublePublisher, NumModules> ntVelocityErrorTopics;
-  // std::array<nt::DoublePublisher, NumModules> ntPositionErrorTopics;
-  // std::array<nt::DoublePublisher, NumModules> ntPositionTopics;
-  // std::array<nt::DoublePublisher, NumModules> ntVelocityTopics;
+  std::optional<SwerveTelemetryPublisher> telemetry;
 
-  nt::DoubleArrayPublisher ntPositionTopics;
-  nt::DoubleArrayPublisher ntVelocityTopics;
+  nt::IntegerPublisher ntDroppedVisionTopic;
+  nt::IntegerPublisher ntVisionAcceptedTopic;
+  nt::IntegerPublisher ntVisionOutlierTopic;
+  nt::IntegerPublisher ntVisionAmbiguityTopic;
+  nt::IntegerPublisher ntVisionStaleTopic;
+  nt::IntegerPublisher ntVisionForcedTopic;
+  nt::DoublePublisher ntVisionDistanceTopic;
 
-  nt::DoubleArrayPublisher ntPositionErrorTopics;
-  nt::DoubleArrayPublisher ntVelocityErrorTopics;
+  //---------
+  // DataLog
+  //---------
 
-  nt::DoubleArrayPublisher ntTargetPositionTopics;
-  nt::DoubleArrayPublisher ntTargetVelocityTopics;
+  DataLogChannel moduleStatesLog;
+  DataLogChannel moduleTargetsLog;
+  DataLogChannel headingLog;
+  DataLogChannel poseLog;
 
   //-----------------
   // Drive Variables
   //-----------------
 
+  /**
+   * Clock from the environment, or empty for the FPGA clock.
+   */
+  std::function<units::second_t()> clock;
+
   /**
    * Array of swerve modules being used.
    */
@@ -266,14 +693,51 @@ private:
    */
   std::shared_ptr<const rmb::Gyro> gyro;
 
+  /**
+   * Module and gyro readings from the most recent call to `sample()`.
+   */
+  SwerveDriveSnapshot<NumModules> snapshot;
+
+  /**
+   * Oldest snapshot the drive methods accept without a warning, one period
+   * of the default 50 Hz robot loop.
+   */
+  static constexpr units::second_t kMaxSnapshotAge = 20_ms;
+
+  mutable std::atomic<bool> staleSnapshotReported = false;
+
+  /**
+   * Open loop powers most recently sent to the modules. Kept so telemetry
+   * does not have to read them back from the motor controllers.
+   */
+  std::array<SwerveModulePower, NumModules> commandedPowers{};
+
   /**
    * Kinematics to convert from module motion to chassis motion and visa versa.
    */
   frc::SwerveDriveKinematics<NumModules> kinematics;
 
+  /**
+   * Limits chassis speed commands to what the modules can follow. Empty when
+   * no limits have been set.
+   */
+  std::optional<SwerveSetpointGenerator<NumModules>> setpointGenerator;
+
+  /**
+   * Setpoint most recently commanded by `driveChassisSpeeds()`.
+   */
+  SwerveSetpoint<NumModules> setpoint;
+
+  /**
+   * FPGA time `setpoint` was generated. Zero when another drive method has
+   * commanded the modules since.
+   */
+  units::second_t setpointTime = 0.0_s;
+
   /**
    * Inverse Kinematics matrix to convert chassis speeds in percentage outputs
-   * to module states
+   * to module states. Multiplying it by `(vx, vy, omega)` gives the x and y
+   * outputs of every module, interleaved.
    */
   Eigen::Matrix<float, 2 * NumModules, 3> openLoopInverseKinematics;
 
@@ -282,6 +746,12 @@ private:
    */
   frc::HolonomicDriveController holonomicController;
 
+  /**
+   * Time between samples when resampling WPILib trajectories. Zero disables
+   * resampling.
+   */
+  units::second_t trajectorySamplePeriod = 0.0_s;
+
   //-------------------
   // Odometry Variables
   //-------------------
@@ -296,9 +766,70 @@ private:
    */
   mutable std::mutex visionThreadMutex;
 
+  /**
+   * Estimator used instead of `poseEstimator` while sensor fusion is
+   * enabled, protected by `visionThreadMutex`.
+   */
+  std::optional<KalmanPoseEstimator> kalmanEstimator;
+
+  /**
+   * Odometry most recently applied to `kalmanEstimator`.
+   */
+  SwerveOdometrySample<NumModules> lastFusedOdometry;
+
+  /**
+   * Vision standard deviations last set by `setVisionSTDevs()`.
+   */
+  std::optional<wpi::array<double, 3>> visionStdDevs;
+
+  /**
+   * Screens vision measurements while set, protected by
+   * `visionThreadMutex`.
+   */
+  std::optional<VisionGate> visionGate;
+
+  /**
+   * Latest estimator output, readable from any thread without locking
+   * `visionThreadMutex`.
+   */
+  SeqLock<SwerveDrivePoseEstimate> publishedPose;
+
+  /**
+   * Estimates recorded by `updatePose()`, protected by `visionThreadMutex`.
+   * 128 entries covers over 2.5 s at 50 Hz.
+   */
+  PoseHistory poseHistory{128};
+
   units::meters_per_second_t maxModuleSpeed;
 
   units::meter_t largestModuleDistance = 1.0_m;
+
+  //-----------------
+  // Odometry Thread
+  //-----------------
+
+  /**
+   * Serializes every read and command of the modules and gyro between the
+   * robot loop and the odometry thread. Controllers are not required to be
+   * thread safe, so nothing may touch them without it while the thread runs.
+   */
+  std::mutex sensorMutex;
+
+  /**
+   * Samples from the odometry thread waiting to be applied by `updatePose()`.
+   * 32 samples covers over 100 ms of a stalled loop at 250 Hz.
+   */
+  SPSCQueue<SwerveOdometrySample<NumModules>, 32> odometrySamples;
+
+  std::atomic<size_t> droppedOdometrySamples = 0;
+
+  std::function<void()> refreshSignals;
+
+  /**
+   * Runs the odometry thread. Declared last so it is stopped before anything
+   * it uses is destroyed.
+   */
+  std::optional<frc::Notifier> odometryNotifier;
 };
 } // namespace rmb
 
@@ -26,10 +26,15 @@
 #include "frc/kinematics/SwerveModuleState.h"
 
 #include "frc/geometry/Translation2d.h"
+#include "frc/geometry/Twist2d.h"
+
+#include "frc/Timer.h"
 
 #include "frc2/command//SwerveControllerCommand.h"
 #include "frc2/command/CommandPtr.h"
 #include "frc2/command/Commands.h"
+#include "frc2/command/FunctionalCommand.h"
+#include "frc2/command/Requirements.h"
 #include "frc2/command/Subsystem.h"
 #include "networktables/NetworkTable.h"
 #include "networktables/NetworkTableInstance.h"
@@ -44,7 +49,9 @@
 #include "wpi/array.h"
 #include "wpi/sendable/SendableRegistry.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <functional>
 #include <initializer_list>
@@ -66,36 +73,71 @@ template <size_t NumModules>
 SwerveDrive<NumModules>::SwerveDrive(
     std::array<SwerveModule, NumModules> modules,
     std::shared_ptr<const rmb::Gyro> gyro,
-    frc::HolonomicDriveController holonomicController, std::string visionTable,
-    units::meters_per_second_t maxModuleSpeed, const frc::Pose2d &initialPose)
-    : modules(std::move(modules)), gyro(gyro),
-      kinematics(std::array<frc::Translation2d, NumModules>{}),
+    frc::HolonomicDriveController holonomicController,
+    const std::vector<std::string> &cameraTables,
+    units::meters_per_second_t maxModuleSpeed, const frc::Pose2d &initialPose,
+    const SwerveDriveEnvironment &environment)
+    : BaseDrive(cameraTables, environment.ntInstance),
+      clock(environment.clock), modules(std::move(modules)), gyro(gyro),
+      kinematics(getModuleTranslations(this->modules)),
       holonomicController(holonomicController),
       poseEstimator(frc::SwerveDrivePoseEstimator<NumModules>(
-          kinematics, gyro->getRotation(), getModulePositions(), initialPose)),
+          kinematics, gyro->getRotation(), snapshot.positions, initialPose)),
       maxModuleSpeed(maxModuleSpeed) {
+  std::shared_ptr<nt::NetworkTable> table =
+      environment.ntInstance.GetTable("swervedrive");
+
+  telemetry.emplace(*table, "modules", NumModules);
+
+  ntDroppedVisionTopic =
+      table->GetIntegerTopic("vision_dropped_measurements").Publish();
+  ntVisionAcceptedTopic =
+      table->GetIntegerTopic("vision_accepted_measurements").Publish();
+  ntVisionOutlierTopic =
+      table->GetIntegerTopic("vision_rejected_outliers").Publish();
+  ntVisionAmbiguityTopic =
+      table->GetIntegerTopic("vision_rejected_ambiguous").Publish();
+  ntVisionStaleTopic =
+      table->GetIntegerTopic("vision_rejected_stale").Publish();
+  ntVisionForcedTopic =
+      table->GetIntegerTopic("vision_forced_accepts").Publish();
+  ntVisionDistanceTopic =
+      table->GetDoubleTopic("vision_mahalanobis_distance").Publish();
+
+  recomputeOpenloopInverseKinematicsMatrix();
+
+  // The estimator was seeded before any sensor data was available.
+  sample();
+  poseEstimator.ResetPosition(snapshot.heading, snapshot.positions,
+                              initialPose);
+  publishedPose.store({initialPose, snapshot.timestamp, getChassisSpeeds()});
+}
+
+template <size_t NumModules>
+SwerveDrive<NumModules>::SwerveDrive(
+    std::array<SwerveModule, NumModules> modules,
+    std::shared_ptr<const rmb::Gyro> gyro,
+    frc::HolonomicDriveController holonomicController,
+    units::meters_per_second_t maxModuleSpeed, const frc::Pose2d &initialPose,
+    const SwerveDriveEnvironment &environment)
+    : SwerveDrive(std::move(modules), gyro, holonomicController, {},
+                  maxModuleSpeed, initialPose, environment) {}
+
+template <size_t NumModules>
+std::array<frc::Translation2d, NumModules>
+SwerveDrive<NumModules>::getModuleTranslations(
+    const std::array<SwerveModule, NumModules> &modules) {
   std::array<frc::Translation2d, NumModules> translations;
   for (size_t i = 0; i < NumModules; i++) {
     translations[i] = modules[i].getModuleTranslation();
   }
-  nt::NetworkTableInstance ntInstance = nt::NetworkTableInstance::GetDefault();
-  std::shared_ptr<nt::NetworkTable> table = ntInstance.GetTable("swervedrive");
-
-  ntPositionTopics = table->GetDoubleArrayTopic("mod_positions").Publish();
-  ntVelocityTopics = table->GetDoubleArrayTopic("mod_velocities").Publish();
-
-  ntPositionErrorTopics =
-      table->GetDoubleArrayTopic("mod_position_errors").Publish();
-  ntVelocityErrorTopics =
-      table->GetDoubleArrayTopic("mod_velocity_errors").Publish();
-
-  ntTargetPositionTopics =
-      table->GetDoubleArrayTopic("mod_position_targets").Publish();
-  ntTargetVelocityTopics =
-      table->GetDoubleArrayTopic("mod_velocity_targets").Publish();
+  return translations;
+}
 
+template <size_t NumModules>
+void SwerveDrive<NumModules>::recomputeOpenloopInverseKinematicsMatrix() {
   units::meter_t maxDistance = 0.0_m;
-  for (SwerveModule &module : this->modules) {
+  for (SwerveModule &module : modules) {
     auto &translation = module.getModuleTranslation();
     units::meter_t distance =
         translation.Distance(frc::Translation2d(0.0_m, 0.0_m));
@@ -104,48 +146,102 @@ SwerveDrive<NumModules>::SwerveDrive(
   }
 
   largestModuleDistance = maxDistance;
+
+  // See driveCartesian() for the derivation of each pair of rows.
+  for (size_t i = 0; i < NumModules; i++) {
+    const frc::Translation2d &translation = modules[i].getModuleTranslation();
+    float x = static_cast<float>(translation.X() / largestModuleDistance);
+    float y = static_cast<float>(translation.Y() / largestModuleDistance);
+
+    openLoopInverseKinematics.row(2 * i) << 1.0f, 0.0f, y;
+    openLoopInverseKinematics.row(2 * i + 1) << 0.0f, 1.0f, -x;
+  }
 }
 
 template <size_t NumModules>
-SwerveDrive<NumModules>::SwerveDrive(
-    std::array<SwerveModule, NumModules> modules,
-    std::shared_ptr<const rmb::Gyro> gyro,
-    frc::HolonomicDriveController holonomicController,
-    units::meters_per_second_t maxModuleSpeed, const frc::Pose2d &initialPose)
-    : SwerveDrive(std::move(modules), gyro, holonomicController, "",
-                  maxModuleSpeed, initialPose) {}
+SwerveDriveSnapshot<NumModules> SwerveDrive<NumModules>::readSnapshot() const {
+  SwerveDriveSnapshot<NumModules> next;
+  next.timestamp = now();
+  next.heading = gyro->getRotation();
+  next.xAcceleration = gyro->getXAcceleration();
+  next.yAcceleration = gyro->getYAcceleration();
 
-template <size_t NumModules>
-std::array<frc::SwerveModulePosition, NumModules>
-SwerveDrive<NumModules>::getModulePositions() const {
-  std::array<frc::SwerveModulePosition, NumModules> states;
   for (size_t i = 0; i < NumModules; i++) {
-    states[i] = modules[i].getPosition();
+    SwerveModuleSample moduleSample = modules[i].sample();
+    next.states[i] = moduleSample.state;
+    next.positions[i] = moduleSample.position;
+    next.targetStates[i] = moduleSample.targetState;
   }
 
-  return states;
+  return next;
 }
 
 template <size_t NumModules>
-std::array<frc::SwerveModuleState, NumModules>
-SwerveDrive<NumModules>::getModuleStates() const {
-  std::array<frc::SwerveModuleState, NumModules> states;
-  for (size_t i = 0; i < NumModules; i++) {
-    states[i] = modules[i].getState();
+const SwerveDriveSnapshot<NumModules> &SwerveDrive<NumModules>::sample() {
+  RMB_PROFILE_ZONE("SwerveDrive::sample");
+  std::lock_guard<std::mutex> lock(sensorMutex);
+  snapshot = readSnapshot();
+
+  if (moduleStatesLog) {
+    // Module angles in turns followed by wheel speeds, module by module.
+    std::array<double, 2 * NumModules> states;
+    std::array<double, 2 * NumModules> targets;
+    for (size_t i = 0; i < NumModules; i++) {
+      const frc::SwerveModuleState &state = snapshot.states[i];
+      const frc::SwerveModuleState &target = snapshot.targetStates[i];
+
+      states[2 * i] = units::turn_t(state.angle.Radians())();
+      states[2 * i + 1] = state.speed();
+      targets[2 * i] = units::turn_t(target.angle.Radians())();
+      targets[2 * i + 1] = target.speed();
+    }
+
+    moduleStatesLog.record(states, snapshot.timestamp);
+    moduleTargetsLog.record(targets, snapshot.timestamp);
+    headingLog.record(std::array{snapshot.heading.Radians()()},
+                      snapshot.timestamp);
   }
 
-  return states;
+  return snapshot;
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::checkSnapshotAge() const {
+  if (now() - snapshot.timestamp <= kMaxSnapshotAge ||
+      staleSnapshotReported.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
+
+  std::cout << "SwerveDrive: module readings are "
+            << units::millisecond_t(now() - snapshot.timestamp).value()
+            << " ms old. Call sample() at the start of every robot loop."
+            << std::endl;
+}
+
+template <size_t NumModules>
+std::array<frc::SwerveModulePosition, NumModules>
+SwerveDrive<NumModules>::getModulePositions() const {
+  checkSnapshotAge();
+  return snapshot.positions;
+}
+
+template <size_t NumModules>
+std::array<frc::SwerveModuleState, NumModules>
+SwerveDrive<NumModules>::getModuleStates() const {
+  checkSnapshotAge();
+  return snapshot.states;
 }
 
 template <size_t NumModules>
 void SwerveDrive<NumModules>::driveCartesian(double xSpeed, double ySpeed,
                                              double zRotation,
                                              bool fieldOriented) {
-
+  RMB_PROFILE_ZONE("SwerveDrive::driveCartesian");
   Eigen::Vector2d robotRelativeVXY = Eigen::Vector2d(xSpeed, ySpeed);
 
   if (fieldOriented) {
-    units::radian_t vXYRotationAngle = -gyro->getRotation().Radians();
+    checkSnapshotAge();
+    units::radian_t vXYRotationAngle = -snapshot.heading.Radians();
 
     Eigen::Matrix2d vXYRotation{
         {std::cos(vXYRotationAngle()), -std::sin(vXYRotationAngle())},
@@ -167,41 +263,34 @@ void SwerveDrive<NumModules>::driveCartesian(double xSpeed, double ySpeed,
    * so,
    * output_x = vx * 1 + vy * 0 + w * y
    * output_y = vx * 0 + vy * 1 + w * -x
+   *
+   * with x and y scaled by the largest module distance. Those rows are stored
+   * in openLoopInverseKinematics so every module is solved in one product.
    */
 
-  std::array<SwerveModulePower, NumModules> powers;
-  double largestPower = 1.0;
-
-  for (size_t i = 0; i < modules.size(); i++) {
-    SwerveModule &module = modules[i];
-
-    double output_x =
-        robotRelativeVXY.x() +
-        zRotation * module.getModuleTranslation().Y() / largestModuleDistance;
-
-    double output_y =
-        robotRelativeVXY.y() +
-        zRotation * -module.getModuleTranslation().X() / largestModuleDistance;
-
-    frc::Rotation2d moduleRotation{output_x, output_y};
-    double modulePower = std::sqrt(output_x * output_x + output_y * output_y);
+  const Eigen::Vector3f chassis{static_cast<float>(robotRelativeVXY.x()),
+                                static_cast<float>(robotRelativeVXY.y()),
+                                static_cast<float>(zRotation)};
 
-    powers[i] = SwerveModulePower{modulePower, moduleRotation};
-
-    if (modulePower > largestPower) {
-      largestPower = modulePower;
-    }
-  }
+  // Column i holds the (x, y) output of module i.
+  Eigen::Matrix<float, 2, NumModules> outputs;
+  Eigen::Map<Eigen::Matrix<float, 2 * NumModules, 1>>(outputs.data()) =
+      openLoopInverseKinematics * chassis;
 
   // Normalize
-  for (SwerveModulePower &power : powers) {
-    power.power /= largestPower;
-  }
+  Eigen::Array<float, 1, NumModules> modulePowers =
+      outputs.colwise().norm().array();
+  modulePowers /= std::max(1.0f, modulePowers.maxCoeff());
 
   // Optimize
-  for (size_t i = 0; i < modules.size(); i++) {
-    powers[i] =
-        SwerveModulePower::Optimize(powers[i], modules[i].getState().angle);
+  std::array<SwerveModulePower, NumModules> powers;
+  for (size_t i = 0; i < NumModules; i++) {
+    frc::Rotation2d moduleRotation{
+        units::radian_t(std::atan2(outputs(1, i), outputs(0, i)))};
+
+    powers[i] = SwerveModulePower::Optimize(
+        SwerveModulePower{modulePowers(i), moduleRotation},
+        snapshot.states[i].angle);
   }
 
   driveModulePowers(powers);
@@ -210,9 +299,14 @@ void SwerveDrive<NumModules>::driveCartesian(double xSpeed, double ySpeed,
 template <size_t NumModules>
 void SwerveDrive<NumModules>::driveModuleStates(
     std::array<frc::SwerveModuleState, NumModules> states) {
+  checkSnapshotAge();
+
+  std::lock_guard<std::mutex> lock(sensorMutex);
   for (size_t i = 0; i < NumModules; i++) {
-    modules[i].setState(states[i]);
+    modules[i].setState(states[i], snapshot.states[i].angle);
   }
+
+  setpointTime = 0.0_s;
 }
 
 template <size_t NumModules>
@@ -228,123 +322,352 @@ void SwerveDrive<NumModules>::drivePolar(double speed,
 template <size_t NumModules>
 void SwerveDrive<NumModules>::driveModulePowers(
     std::array<SwerveModulePower, NumModules> powers) {
-  // std::cout << "powers: ";
-  for (size_t i = 0; i < NumModules; i++) {
-    modules[i].setPower(powers[i]);
+  {
+    std::lock_guard<std::mutex> lock(sensorMutex);
+    for (size_t i = 0; i < NumModules; i++) {
+      modules[i].setPower(powers[i]);
+    }
   }
+
+  commandedPowers = powers;
+  setpointTime = 0.0_s;
 }
 
 template <size_t NumModules>
 void SwerveDrive<NumModules>::driveChassisSpeeds(
     frc::ChassisSpeeds chassisSpeeds) {
-  auto states = kinematics.ToSwerveModuleStates(chassisSpeeds);
-  kinematics.DesaturateWheelSpeeds(&states, maxModuleSpeed);
-  driveModuleStates(states);
+  RMB_PROFILE_ZONE("SwerveDrive::driveChassisSpeeds");
+  if (!setpointGenerator) {
+    auto states = kinematics.ToSwerveModuleStates(chassisSpeeds);
+    kinematics.DesaturateWheelSpeeds(&states, maxModuleSpeed);
+    driveModuleStates(states);
+    return;
+  }
+
+  units::second_t time = now();
+  units::second_t dt = time - setpointTime;
+
+  // Start from what the modules are actually doing when the last setpoint
+  // is stale or was overridden by another drive method.
+  if (setpointTime == 0.0_s || dt > 0.1_s) {
+    setpoint.chassisSpeeds = getChassisSpeeds();
+    setpoint.moduleStates = snapshot.states;
+    dt = 20_ms;
+  }
+
+  SwerveSetpoint<NumModules> next =
+      setpointGenerator->generate(setpoint, chassisSpeeds, dt);
+  driveModuleStates(next.moduleStates);
+
+  setpoint = next;
+  setpointTime = time;
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::setSetpointLimits(
+    const SwerveSetpointLimits &limits) {
+  setpointGenerator.emplace(getModuleTranslations(modules), maxModuleSpeed,
+                            limits);
+  setpointTime = 0.0_s;
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::clearSetpointLimits() {
+  setpointGenerator.reset();
 }
 
 template <size_t NumModules>
 frc::ChassisSpeeds SwerveDrive<NumModules>::getChassisSpeeds() const {
   return kinematics.ToChassisSpeeds(
-      wpi::array<frc::SwerveModuleState, NumModules>(getModuleStates()));
+      wpi::array<frc::SwerveModuleState, NumModules>(snapshot.states));
 }
 
 template <size_t NumModules>
 frc::Pose2d SwerveDrive<NumModules>::getPose() const {
-  std::lock_guard<std::mutex> lock(visionThreadMutex);
-  return poseEstimator.GetEstimatedPosition();
+  return publishedPose.load().pose;
 }
 
-template <size_t NumModules> frc::Pose2d SwerveDrive<NumModules>::updatePose() {
-  std::lock_guard<std::mutex> lock(visionThreadMutex);
-  return poseEstimator.Update(
-      frc::Rotation2d((units::radian_t)gyro->getZRotation()),
-      getModulePositions());
+template <size_t NumModules>
+SwerveDrivePoseEstimate SwerveDrive<NumModules>::getPoseEstimate() const {
+  return publishedPose.load();
 }
 
 template <size_t NumModules>
-void SwerveDrive<NumModules>::updateNTDebugInfo(bool openLoopVelocity) {
-  std::array<double, NumModules> velocityErrors;
-  for (size_t i = 0; i < NumModules; i++) {
-    units::meters_per_second_t error = 0.0_mps;
-    if (!openLoopVelocity) {
-      error = modules[i].getTargetState().speed - modules[i].getState().speed;
-    } else {
+std::optional<TimestampedPose>
+SwerveDrive<NumModules>::getPoseAt(units::second_t timestamp) const {
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
+  return poseHistory.sample(timestamp);
+}
 
-      velocityErrors[i] = error();
-    }
-    ntVelocityErrorTopics.Set(velocityErrors);
+template <size_t NumModules> frc::Pose2d SwerveDrive<NumModules>::updatePose() {
+  RMB_PROFILE_ZONE("SwerveDrive::updatePose");
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
 
-    std::array<double, NumModules> positionErrors;
-    for (size_t i = 0; i < NumModules; i++) {
-      units::turn_t error = modules[i].getTargetRotation().Degrees() -
-                            modules[i].getState().angle.Degrees();
+  // Vision received on the NetworkTables thread since the last update.
+  // Measurements arriving after this wait for the next update.
+  std::span<const VisionMeasurement> vision = takeVisionMeasurements();
+
+  units::second_t timestamp = snapshot.timestamp;
+  frc::Pose2d pose;
 
-      positionErrors[i] = error();
+  if (kalmanEstimator) {
+    timestamp = updateSensorFusion(vision);
+    pose = kalmanEstimator->getPose();
+  } else {
+    if (!odometryNotifier) {
+      poseEstimator.UpdateWithTime(snapshot.timestamp, snapshot.heading,
+                                   snapshot.positions);
+    } else {
+      // Apply everything the odometry thread recorded since the last update.
+      timestamp = publishedPose.load().timestamp;
+
+      SwerveOdometrySample<NumModules> odometrySample;
+      while (odometrySamples.pop(odometrySample)) {
+        poseEstimator.UpdateWithTime(odometrySample.timestamp,
+                                     odometrySample.heading,
+                                     odometrySample.positions);
+        timestamp = odometrySample.timestamp;
+      }
     }
-    ntPositionErrorTopics.Set(positionErrors);
 
-    std::array<double, NumModules> velocityTargets;
-    for (size_t i = 0; i < NumModules; i++) {
-      double target = 0.0;
+    // Vision is compensated back to odometry already applied, so it goes
+    // last. Applied first, the odometry after it would count the motion
+    // since the capture a second time.
+    for (VisionMeasurement measurement : vision) {
+      if (!gateVisionMeasurement(measurement)) {
+        continue;
+      }
 
-      if (!openLoopVelocity) {
-        target = modules[i].getTargetVelocity()();
+      if (measurement.stdDevs) {
+        poseEstimator.AddVisionMeasurement(
+            measurement.pose, measurement.timestamp, *measurement.stdDevs);
       } else {
-        target = modules[i].getPower().power;
+        poseEstimator.AddVisionMeasurement(measurement.pose,
+                                           measurement.timestamp);
       }
-
-      velocityTargets[i] = target;
     }
-    ntTargetVelocityTopics.Set(velocityTargets);
 
-    std::array<double, NumModules> positionTargets;
-    for (size_t i = 0; i < NumModules; i++) {
-      units::degree_t target = modules[i].getTargetRotation().Degrees();
+    pose = poseEstimator.GetEstimatedPosition();
+  }
+
+  frc::ChassisSpeeds chassisSpeeds = getChassisSpeeds();
+  publishedPose.store({pose, timestamp, chassisSpeeds});
+  poseHistory.record({timestamp, pose, chassisSpeeds});
+  poseLog.record(
+      std::array{pose.X()(), pose.Y()(), pose.Rotation().Radians()()},
+      timestamp);
+  return pose;
+}
 
-      positionTargets[i] = target();
+template <size_t NumModules>
+units::second_t SwerveDrive<NumModules>::updateSensorFusion(
+    std::span<const VisionMeasurement> vision) {
+  units::second_t timestamp = snapshot.timestamp;
+
+  if (!odometryNotifier) {
+    fuseOdometry(getSnapshotOdometry());
+  } else {
+    timestamp = publishedPose.load().timestamp;
+
+    SwerveOdometrySample<NumModules> odometrySample;
+    while (odometrySamples.pop(odometrySample)) {
+      fuseOdometry(odometrySample);
+      timestamp = odometrySample.timestamp;
     }
-    ntTargetPositionTopics.Set(positionTargets);
+  }
 
-    std::array<double, NumModules> positions;
-    for (size_t i = 0; i < NumModules; i++) {
-      units::turn_t position = modules[i].getState().angle.Degrees();
+  // Vision is compensated back to odometry already applied, so it goes last.
+  for (VisionMeasurement measurement : vision) {
+    if (!gateVisionMeasurement(measurement)) {
+      continue;
+    }
 
-      positions[i] = position();
+    if (measurement.stdDevs) {
+      kalmanEstimator->addVisionMeasurement(
+          measurement.pose, measurement.timestamp, *measurement.stdDevs);
+    } else {
+      kalmanEstimator->addVisionMeasurement(measurement.pose,
+                                            measurement.timestamp);
     }
-    ntPositionTopics.Set(positions);
+  }
 
-    std::array<double, NumModules> velocities;
-    for (size_t i = 0; i < NumModules; i++) {
-      units::meters_per_second_t velocity = modules[i].getState().speed;
+  return timestamp;
+}
 
-      velocities[i] = velocity();
-    }
-    ntVelocityTopics.Set(velocities);
+template <size_t NumModules>
+bool SwerveDrive<NumModules>::gateVisionMeasurement(
+    VisionMeasurement &measurement) {
+  if (!visionGate) {
+    return true;
+  }
+
+  // Compare against the estimate from when the frame was captured.
+  std::optional<TimestampedPose> estimate =
+      poseHistory.sample(measurement.timestamp);
+
+  std::optional<Eigen::Matrix3d> covariance;
+  if (kalmanEstimator) {
+    covariance = kalmanEstimator->getPoseCovariance();
+  }
+
+  std::optional<frc::Pose2d> estimatePose;
+  frc::ChassisSpeeds speeds;
+  if (estimate) {
+    estimatePose = estimate->pose;
+    speeds = estimate->chassisSpeeds;
+  }
+
+  std::optional<wpi::array<double, 3>> stdDevs =
+      visionGate->evaluate(measurement, estimatePose, covariance, speeds);
+  if (!stdDevs) {
+    return false;
   }
+
+  measurement.stdDevs = stdDevs;
+  return true;
 }
 
 template <size_t NumModules>
-std::array<frc::SwerveModuleState, NumModules>
-SwerveDrive<NumModules>::getTargetModuleStates() const {
-  std::array<frc::SwerveModuleState, NumModules> targetStates;
+SwerveOdometrySample<NumModules>
+SwerveDrive<NumModules>::getSnapshotOdometry() const {
+  SwerveOdometrySample<NumModules> odometrySample;
+  odometrySample.timestamp = snapshot.timestamp;
+  odometrySample.heading = snapshot.heading;
+  odometrySample.positions = snapshot.positions;
+  odometrySample.xAcceleration = snapshot.xAcceleration;
+  odometrySample.yAcceleration = snapshot.yAcceleration;
+  return odometrySample;
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::fuseOdometry(
+    const SwerveOdometrySample<NumModules> &sample) {
+  units::second_t dt = sample.timestamp - lastFusedOdometry.timestamp;
+
+  // Average speeds since the last sample, which is what the filter expects.
+  frc::ChassisSpeeds speeds;
+  if (dt > 0.0_s) {
+    frc::Twist2d twist = kinematics.ToTwist2d(
+        wpi::array<frc::SwerveModulePosition, NumModules>(
+            lastFusedOdometry.positions),
+        wpi::array<frc::SwerveModulePosition, NumModules>(sample.positions));
+    speeds = {twist.dx / dt, twist.dy / dt, twist.dtheta / dt};
+  }
+
+  kalmanEstimator->update(sample.timestamp, sample.heading, speeds,
+                          sample.xAcceleration, sample.yAcceleration);
+  lastFusedOdometry = sample;
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::updateNTDebugInfo(bool openLoopVelocity) {
+  std::array<SwerveModuleTelemetry, NumModules> modulesTelemetry;
+
   for (size_t i = 0; i < NumModules; i++) {
-    targetStates[i] = modules[i].getTargetState();
+    const frc::SwerveModuleState &state = snapshot.states[i];
+    const frc::SwerveModuleState &target = snapshot.targetStates[i];
+    SwerveModuleTelemetry &module = modulesTelemetry[i];
+
+    module.position = units::turn_t(state.angle.Degrees())();
+    module.velocity = state.speed();
+
+    module.targetPosition = units::turn_t(target.angle.Degrees())();
+    module.targetVelocity =
+        openLoopVelocity ? commandedPowers[i].power : target.speed();
+
+    module.positionError = module.targetPosition - module.position;
+    module.velocityError =
+        openLoopVelocity ? 0.0 : module.targetVelocity - module.velocity;
   }
 
-  return targetStates;
+  telemetry->publish(modulesTelemetry, snapshot.timestamp);
+
+  ntDroppedVisionTopic.Set(getDroppedVisionMeasurements());
+
+  if (std::optional<VisionGateHelper::Statistics> statistics =
+          getVisionGateStatistics()) {
+    ntVisionAcceptedTopic.Set(statistics->accepted);
+    ntVisionOutlierTopic.Set(statistics->rejectedOutlier);
+    ntVisionAmbiguityTopic.Set(statistics->rejectedAmbiguity);
+    ntVisionStaleTopic.Set(statistics->rejectedStale);
+    ntVisionForcedTopic.Set(statistics->forcedAccepts);
+    ntVisionDistanceTopic.Set(statistics->lastDistance);
+  }
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::setDataLogRecorder(
+    std::shared_ptr<DataLogRecorder> recorder) {
+  static_assert(2 * NumModules <= DataLogRecorder::kMaxValues,
+                "Too many modules to record in a single DataLog record");
+
+  moduleStatesLog = DataLogChannel(recorder, "swervedrive/module_states",
+                                   "angle (turns), speed (m/s) per module");
+  moduleTargetsLog = DataLogChannel(recorder, "swervedrive/module_targets",
+                                    "angle (turns), speed (m/s) per module");
+  headingLog = DataLogChannel(recorder, "swervedrive/heading", "radians");
+  poseLog = DataLogChannel(recorder, "swervedrive/pose",
+                           "x (m), y (m), theta (radians)");
+}
+
+template <size_t NumModules>
+std::array<frc::SwerveModuleState, NumModules>
+SwerveDrive<NumModules>::getTargetModuleStates() const {
+  return snapshot.targetStates;
 }
 
 template <size_t NumModules>
 void SwerveDrive<NumModules>::resetPose(const frc::Pose2d &pose) {
+  {
+    // Resample so a gyro or encoder reset since the last loop is not lost,
+    // and discard odometry recorded before the reset.
+    std::lock_guard<std::mutex> sensorLock(sensorMutex);
+    odometrySamples.clear();
+    snapshot = readSnapshot();
+  }
+
   std::lock_guard<std::mutex> lock(visionThreadMutex);
-  poseEstimator.ResetPosition(gyro->getRotation(), getModulePositions(), pose);
+  poseEstimator.ResetPosition(snapshot.heading, snapshot.positions, pose);
+
+  if (kalmanEstimator) {
+    kalmanEstimator->reset(snapshot.heading, pose, snapshot.timestamp);
+    lastFusedOdometry = getSnapshotOdometry();
+  }
+
+  // Estimates from before the reset are in a different frame.
+  frc::ChassisSpeeds chassisSpeeds = getChassisSpeeds();
+  publishedPose.store({pose, snapshot.timestamp, chassisSpeeds});
+  poseHistory.clear();
+  poseHistory.record({snapshot.timestamp, pose, chassisSpeeds});
 }
 
 template <size_t NumModules>
 void SwerveDrive<NumModules>::addVisionMeasurments(
     const frc::Pose2d &poseEstimate, units::second_t time) {
   std::lock_guard<std::mutex> lock(visionThreadMutex);
-  poseEstimator.AddVisionMeasurement(poseEstimate, time);
+
+  VisionMeasurement measurement;
+  measurement.pose = poseEstimate;
+  measurement.timestamp = time;
+  if (!gateVisionMeasurement(measurement)) {
+    return;
+  }
+
+  if (kalmanEstimator) {
+    if (measurement.stdDevs) {
+      kalmanEstimator->addVisionMeasurement(poseEstimate, time,
+                                            *measurement.stdDevs);
+    } else {
+      kalmanEstimator->addVisionMeasurement(poseEstimate, time);
+    }
+  } else {
+    if (measurement.stdDevs) {
+      poseEstimator.AddVisionMeasurement(poseEstimate, time,
+                                         *measurement.stdDevs);
+    } else {
+      poseEstimator.AddVisionMeasurement(poseEstimate, time);
+    }
+  }
 }
 
 template <size_t NumModules>
@@ -352,6 +675,61 @@ void SwerveDrive<NumModules>::setVisionSTDevs(
     wpi::array<double, 3> standardDevs) {
   std::lock_guard<std::mutex> lock(visionThreadMutex);
   poseEstimator.SetVisionMeasurementStdDevs(standardDevs);
+  if (kalmanEstimator) {
+    kalmanEstimator->setVisionStdDevs(standardDevs);
+  }
+
+  visionStdDevs = standardDevs;
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::enableSensorFusion(
+    const KalmanPoseEstimatorHelper::NoiseConfig &noise) {
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
+
+  KalmanPoseEstimatorHelper::NoiseConfig config = noise;
+  if (visionStdDevs) {
+    config.vision = *visionStdDevs;
+  }
+
+  kalmanEstimator.emplace(config, snapshot.heading, publishedPose.load().pose,
+                          snapshot.timestamp);
+  lastFusedOdometry = getSnapshotOdometry();
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::disableSensorFusion() {
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
+  if (!kalmanEstimator) {
+    return;
+  }
+
+  poseEstimator.ResetPosition(snapshot.heading, snapshot.positions,
+                              kalmanEstimator->getPose());
+  kalmanEstimator.reset();
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::setVisionGate(
+    const VisionGateHelper::Config &config) {
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
+  visionGate.emplace(config);
+}
+
+template <size_t NumModules> void SwerveDrive<NumModules>::clearVisionGate() {
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
+  visionGate.reset();
+}
+
+template <size_t NumModules>
+std::optional<VisionGateHelper::Statistics>
+SwerveDrive<NumModules>::getVisionGateStatistics() const {
+  std::lock_guard<std::mutex> lock(visionThreadMutex);
+  if (!visionGate) {
+    return std::nullopt;
+  }
+
+  return visionGate->getStatistics();
 }
 
 template <size_t NumModules>
@@ -359,6 +737,13 @@ frc2::CommandPtr SwerveDrive<NumModules>::followWPILibTrajectory(
     frc::Trajectory trajectory,
     std::initializer_list<frc2::Subsystem *> driveRequirements) {
 
+  if (trajectorySamplePeriod > 0.0_s) {
+    return followSampledTrajectory(
+        std::make_shared<const SampledTrajectory>(trajectory,
+                                                  trajectorySamplePeriod),
+        driveRequirements);
+  }
+
   return frc2::SwerveControllerCommand<NumModules>(
              trajectory, [this]() { return getPose(); }, kinematics,
              holonomicController,
@@ -369,6 +754,54 @@ frc2::CommandPtr SwerveDrive<NumModules>::followWPILibTrajectory(
       .ToPtr();
 }
 
+template <size_t NumModules>
+frc2::CommandPtr SwerveDrive<NumModules>::followWPILibTrajectoryGroup(
+    std::vector<frc::Trajectory> trajectoryGroup,
+    std::initializer_list<frc2::Subsystem *> driveRequirements) {
+
+  if (trajectorySamplePeriod > 0.0_s) {
+    return followSampledTrajectory(
+        std::make_shared<const SampledTrajectory>(trajectoryGroup,
+                                                  trajectorySamplePeriod),
+        driveRequirements);
+  }
+
+  return BaseDrive::followWPILibTrajectoryGroup(std::move(trajectoryGroup),
+                                                driveRequirements);
+}
+
+template <size_t NumModules>
+frc2::CommandPtr SwerveDrive<NumModules>::followSampledTrajectory(
+    std::shared_ptr<const SampledTrajectory> trajectory,
+    std::initializer_list<frc2::Subsystem *> driveRequirements) {
+
+  auto timer = std::make_shared<frc::Timer>();
+
+  // Each run gets a fresh copy of the controller, like
+  // frc2::SwerveControllerCommand, so the heading profile and the PID state
+  // never carry over from an earlier path.
+  auto controller =
+      std::make_shared<std::optional<frc::HolonomicDriveController>>();
+
+  return frc2::FunctionalCommand(
+             [this, timer, controller]() {
+               controller->emplace(holonomicController);
+               timer->Restart();
+             },
+             [this, timer, trajectory, controller]() {
+               units::second_t t = timer->Get();
+               driveChassisSpeeds((*controller)->Calculate(
+                   getPose(), trajectory->sample(t),
+                   trajectory->getTargetRotation(t)));
+             },
+             [timer](bool interrupted) { timer->Stop(); },
+             [timer, trajectory]() {
+               return timer->HasElapsed(trajectory->getTotalTime());
+             },
+             driveRequirements)
+      .ToPtr();
+}
+
 template <size_t NumModules>
 frc2::CommandPtr SwerveDrive<NumModules>::followPPPath(
     std::shared_ptr<pathplanner::PathPlannerPath> path,
@@ -412,10 +845,85 @@ frc2::CommandPtr SwerveDrive<NumModules>::FollowGeneratedPPPath(
       .ToPtr();
 }
 
+template <size_t NumModules>
+frc2::CommandPtr SwerveDrive<NumModules>::FollowGeneratedPPPath(
+    std::shared_ptr<PathfindingService> pathfinder, frc::Pose2d targetPose,
+    std::initializer_list<frc2::Subsystem *> driveRequirements) {
+
+  auto handle = std::make_shared<PathfindingHandle>();
+
+  // The initializer list does not outlive this call, so copy it for the
+  // deferred command.
+  frc2::Requirements requirements(driveRequirements);
+
+  return frc2::cmd::Sequence(
+      frc2::cmd::RunOnce([this, pathfinder, handle, targetPose]() {
+        *handle = pathfinder->request(getPose(), targetPose);
+      }),
+      frc2::cmd::WaitUntil([handle]() { return handle->isReady(); }),
+      frc2::cmd::Defer(
+          [this, handle]() {
+            std::shared_ptr<pathplanner::PathPlannerPath> path = handle->get();
+            if (!path) {
+              return frc2::cmd::None();
+            }
+
+            // Requirements are held by the deferring command.
+            return followPPPath(path, {});
+          },
+          requirements));
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::startOdometryThread(
+    units::hertz_t frequency, std::function<void()> refreshSignals) {
+  stopOdometryThread();
+
+  this->refreshSignals = std::move(refreshSignals);
+  odometrySamples.clear();
+
+  odometryNotifier.emplace([this]() { sampleOdometry(); });
+  odometryNotifier->SetName("SwerveOdometry");
+  odometryNotifier->StartPeriodic(1.0 / frequency);
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::stopOdometryThread() {
+  // Destroying the notifier waits for a running sample to finish.
+  odometryNotifier.reset();
+}
+
+template <size_t NumModules>
+void SwerveDrive<NumModules>::sampleOdometry() {
+  std::lock_guard<std::mutex> lock(sensorMutex);
+
+  if (refreshSignals) {
+    refreshSignals();
+  }
+
+  SwerveOdometrySample<NumModules> odometrySample;
+  odometrySample.timestamp = now();
+  odometrySample.heading = gyro->getRotation();
+  for (size_t i = 0; i < NumModules; i++) {
+    odometrySample.positions[i] = modules[i].getPosition();
+  }
+  odometrySample.xAcceleration = gyro->getXAcceleration();
+  odometrySample.yAcceleration = gyro->getYAcceleration();
+
+  if (!odometrySamples.push(odometrySample)) {
+    droppedOdometrySamples.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
 template <size_t NumModules> void SwerveDrive<NumModules>::stop() {
-  for (auto &module : modules) {
-    module.stop();
+  {
+    std::lock_guard<std::mutex> lock(sensorMutex);
+    for (auto &module : modules) {
+      module.stop();
+    }
   }
+
+  setpointTime = 0.0_s;
 }
 
 } // namespace rmb
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+
+#include "units/length.h"
+#include "units/mass.h"
+#include "units/moment_of_inertia.h"
+#include "units/time.h"
+
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+#include "rmb/sensors/sim/SimGyro.h"
+
+namespace rmb {
+
+/**
+ * Simulates the motion of a swerve drivetrain on the floor, so `SwerveDrive`
+ * and the commands using it run unchanged against simulated controllers and
+ * a `SimGyro`.
+ *
+ * Every `SimMechanism::kControlPeriod` the simulator solves the friction
+ * between each wheel and the floor, limited by the friction coefficient so
+ * wheels slip under hard acceleration, then steps every `SimMechanism` with
+ * the resulting load on the drive wheels and moves the chassis. Time only
+ * advances through `update()`, so a routine can run much faster than real
+ * time and gives the same result every run. To run robot code faster than
+ * real time as well, pause WPILib's clock with `frc::sim::PauseTiming()` and
+ * advance it by the same `dt` with `frc::sim::StepTiming()`.
+ *
+ * @tparam NumModules Number of swerve modules.
+ */
+template <size_t NumModules> class SwerveDriveSim {
+public:
+  struct ModuleConfig {
+    /**
+     * Mechanism turning the wheel. Its moment of inertia should only cover
+     * the wheel and drivetrain, since the simulator applies the mass of the
+     * robot through the floor.
+     */
+    SimMechanism *drive;
+    SimMechanism *steer; /*< Mechanism turning the module, 0 rad forward. */
+    units::meter_t wheelRadius;
+    frc::Translation2d translation; /*< From the center of the robot. */
+  };
+
+  struct ChassisConfig {
+    units::kilogram_t mass = 50.0_kg;
+    units::kilogram_square_meter_t moi = 5.0_kg_sq_m; /*< About vertical. */
+    double frictionCoefficient = 1.1; /*< Between the wheels and floor. */
+  };
+
+  /** Passes of the friction solver over the modules each step. */
+  static constexpr int kSolverIterations = 4;
+
+  /**
+   * Creates a simulator. The mechanisms and gyro must outlive it.
+   *
+   * @param modules Mechanisms and geometry of each module.
+   * @param chassis Mass properties of the robot.
+   * @param gyro    Gyro to report the simulated heading and motion to.
+   */
+  SwerveDriveSim(const std::array<ModuleConfig, NumModules> &modules,
+                 const ChassisConfig &chassis, std::shared_ptr<SimGyro> gyro);
+
+  /**
+   * Advances the drivetrain and every `SimMechanism` created on the calling
+   * thread by `dt` in steps of `SimMechanism::kControlPeriod`. Do not also
+   * call `SimMechanism::updateAll()`. Time left over is carried into the
+   * next update.
+   */
+  void update(units::second_t dt);
+
+  /**
+   * Returns the true pose of the robot on the field.
+   */
+  frc::Pose2d getPose() const;
+
+  /**
+   * Moves the robot to a pose and stops it.
+   */
+  void resetPose(const frc::Pose2d &pose);
+
+  /**
+   * Returns the true robot relative velocity.
+   */
+  frc::ChassisSpeeds getChassisSpeeds() const;
+
+  /**
+   * Returns whether a module's wheel slipped during the last step.
+   */
+  bool isSlipping(size_t module) const { return slipping[module]; }
+
+private:
+  /**
+   * Solves wheel friction and advances one control period.
+   */
+  void step();
+
+  std::array<ModuleConfig, NumModules> modules;
+  double mass, moi, maxModuleImpulse;
+  std::shared_ptr<SimGyro> gyro;
+
+  // Chassis state, with the velocity in the field frame.
+  double x = 0.0, y = 0.0, heading = 0.0;
+  double vx = 0.0, vy = 0.0, omega = 0.0;
+
+  std::array<bool, NumModules> slipping{};
+  units::second_t pendingTime = 0.0_s;
+};
+} // namespace rmb
+
+#include "SwerveDriveSim.inl"
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "rmb/drive/SwerveDriveSim.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rmb {
+
+template <size_t NumModules>
+SwerveDriveSim<NumModules>::SwerveDriveSim(
+    const std::array<ModuleConfig, NumModules> &modules,
+    const ChassisConfig &chassis, std::shared_ptr<SimGyro> gyro)
+    : modules(modules), mass(chassis.mass.value()), moi(chassis.moi.value()),
+      gyro(std::move(gyro)) {
+  // Each module carries an equal share of the weight.
+  constexpr double gravity = 9.80665;
+  maxModuleImpulse = chassis.frictionCoefficient * mass * gravity /
+                     NumModules * SimMechanism::kControlPeriod.value();
+}
+
+template <size_t NumModules>
+void SwerveDriveSim<NumModules>::update(units::second_t dt) {
+  pendingTime += dt;
+
+  // Same tolerance as SimMechanism so the two stay in step.
+  while (pendingTime >= SimMechanism::kControlPeriod * (1.0 - 1e-9)) {
+    step();
+    pendingTime -= SimMechanism::kControlPeriod;
+  }
+}
+
+template <size_t NumModules>
+frc::Pose2d SwerveDriveSim<NumModules>::getPose() const {
+  return frc::Pose2d(units::meter_t(x), units::meter_t(y),
+                     frc::Rotation2d(units::radian_t(heading)));
+}
+
+template <size_t NumModules>
+void SwerveDriveSim<NumModules>::resetPose(const frc::Pose2d &pose) {
+  x = pose.X().value();
+  y = pose.Y().value();
+  heading = pose.Rotation().Radians().value();
+  vx = vy = omega = 0.0;
+
+  gyro->setState({heading});
+}
+
+template <size_t NumModules>
+frc::ChassisSpeeds SwerveDriveSim<NumModules>::getChassisSpeeds() const {
+  double cosHeading = std::cos(heading), sinHeading = std::sin(heading);
+  return {units::meters_per_second_t(cosHeading * vx + sinHeading * vy),
+          units::meters_per_second_t(-sinHeading * vx + cosHeading * vy),
+          units::radians_per_second_t(omega)};
+}
+
+template <size_t NumModules> void SwerveDriveSim<NumModules>::step() {
+  const double h = SimMechanism::kControlPeriod.value();
+  const double cosHeading = std::cos(heading), sinHeading = std::sin(heading);
+
+  // Work in the robot frame.
+  const double startVx = cosHeading * vx + sinHeading * vy;
+  const double startVy = -sinHeading * vx + cosHeading * vy;
+  double robotVx = startVx, robotVy = startVy, robotOmega = omega;
+
+  struct Contact {
+    double rx, ry;             /* <- Contact point from the robot center. */
+    double ux, uy;             /* <- Direction the wheel rolls. */
+    double wheelSpeed;         /* <- Surface speed of the wheel. */
+    double wheelMass;          /* <- Wheel inertia seen at its surface. */
+    double longitudinalMass;   /* <- Effective mass along the wheel. */
+    double lateralMass;        /* <- Effective mass across the wheel. */
+    double longitudinalImpulse = 0.0, lateralImpulse = 0.0;
+  };
+
+  std::array<Contact, NumModules> contacts;
+  for (size_t i = 0; i < NumModules; i++) {
+    const ModuleConfig &module = modules[i];
+    Contact &contact = contacts[i];
+
+    double angle = module.steer->getTruePosition().value();
+    double radius = module.wheelRadius.value();
+
+    contact.rx = module.translation.X().value();
+    contact.ry = module.translation.Y().value();
+    contact.ux = std::cos(angle);
+    contact.uy = std::sin(angle);
+    contact.wheelSpeed = module.drive->getTrueVelocity().value() * radius;
+    contact.wheelMass = module.drive->getMoi().value() / (radius * radius);
+
+    // Mass felt by an impulse at the contact point, from the chassis
+    // translating and rotating and, along the wheel, the wheel spinning.
+    double longitudinalArm = contact.rx * contact.uy - contact.ry * contact.ux;
+    double lateralArm = contact.rx * contact.ux + contact.ry * contact.uy;
+    contact.longitudinalMass =
+        1.0 / (1.0 / mass + longitudinalArm * longitudinalArm / moi +
+               1.0 / contact.wheelMass);
+    contact.lateralMass =
+        1.0 / (1.0 / mass + lateralArm * lateralArm / moi);
+  }
+
+  // Sequential impulses: each pass drives every contact's slip to zero given
+  // the impulses already applied by the others, keeping the total impulse of
+  // each module within its friction limit.
+  for (int iteration = 0; iteration < kSolverIterations; iteration++) {
+    for (Contact &contact : contacts) {
+      double groundVx = robotVx - robotOmega * contact.ry;
+      double groundVy = robotVy + robotOmega * contact.rx;
+
+      double longitudinalSlip =
+          contact.wheelSpeed - (contact.ux * groundVx + contact.uy * groundVy);
+      double lateralSlip = -contact.uy * groundVx + contact.ux * groundVy;
+
+      double longitudinal = contact.longitudinalImpulse +
+                            longitudinalSlip * contact.longitudinalMass;
+      double lateral =
+          contact.lateralImpulse - lateralSlip * contact.lateralMass;
+
+      double magnitude = std::hypot(longitudinal, lateral);
+      if (magnitude > maxModuleImpulse) {
+        longitudinal *= maxModuleImpulse / magnitude;
+        lateral *= maxModuleImpulse / magnitude;
+      }
+
+      double deltaLongitudinal = longitudinal - contact.longitudinalImpulse;
+      double deltaLateral = lateral - contact.lateralImpulse;
+      contact.longitudinalImpulse = longitudinal;
+      contact.lateralImpulse = lateral;
+
+      double impulseX = deltaLongitudinal * contact.ux -
+                        deltaLateral * contact.uy;
+      double impulseY = deltaLongitudinal * contact.uy +
+                        deltaLateral * contact.ux;
+
+      robotVx += impulseX / mass;
+      robotVy += impulseY / mass;
+      robotOmega += (contact.rx * impulseY - contact.ry * impulseX) / moi;
+      contact.wheelSpeed -= deltaLongitudinal / contact.wheelMass;
+    }
+  }
+
+  // The wheels feel the reaction as a torque over the coming step.
+  for (size_t i = 0; i < NumModules; i++) {
+    const Contact &contact = contacts[i];
+    slipping[i] = std::hypot(contact.longitudinalImpulse,
+                             contact.lateralImpulse) >=
+                  maxModuleImpulse * (1.0 - 1e-9);
+
+    modules[i].drive->setLoadTorque(units::newton_meter_t(
+        -contact.longitudinalImpulse * modules[i].wheelRadius.value() / h));
+  }
+
+  SimMechanism::updateAll(SimMechanism::kControlPeriod);
+
+  vx = cosHeading * robotVx - sinHeading * robotVy;
+  vy = sinHeading * robotVx + cosHeading * robotVy;
+  omega = robotOmega;
+
+  x += vx * h;
+  y += vy * h;
+  heading += omega * h;
+
+  SimGyro::State state;
+  state.heading = heading;
+
+  // The velocities were solved in the frame the robot started the step in,
+  // which does not turn with it, so their change is the inertial
+  // acceleration an accelerometer reads. It already includes the centripetal
+  // term, omega x v in the turning frame.
+  state.xAcceleration = (robotVx - startVx) / h;
+  state.yAcceleration = (robotVy - startVy) / h;
+
+  // Velocity is reported in the frame the robot ends the step in.
+  const double cosEndHeading = std::cos(heading);
+  const double sinEndHeading = std::sin(heading);
+  state.xVelocity = cosEndHeading * vx + sinEndHeading * vy;
+  state.yVelocity = -sinEndHeading * vx + cosEndHeading * vy;
+  gyro->setState(state);
+}
+
+} // namespace rmb
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include <frc/controller/PIDController.h>
+#include <frc/controller/ProfiledPIDController.h>
+#include <frc/geometry/Translation2d.h>
+
+#include "units/angle.h"
+#include "units/angular_acceleration.h"
+#include "units/angular_velocity.h"
+#include "units/length.h"
+#include "units/time.h"
+#include "units/velocity.h"
+
+#include "rmb/drive/SampledTrajectory.h"
+#include "rmb/drive/SwerveDriveSim.h"
+#include "rmb/drive/SwerveSetpointGenerator.h"
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+
+namespace rmb {
+
+namespace SwerveGainSweepHelper {
+
+struct ModuleConfig {
+  SimMechanismHelper::MotorConfig driveMotor;
+  SimMechanismHelper::EncoderConfig driveEncoder;
+  SimMechanismHelper::MotorConfig steerMotor;
+  SimMechanismHelper::EncoderConfig steerEncoder;
+  units::meter_t wheelRadius = 2.0_in;
+  frc::Translation2d translation; /*< From the center of the robot. */
+};
+
+/**
+ * Gains tried by one run of the sweep.
+ */
+struct GainSet {
+  SimMechanismHelper::PIDConfig drivePID; /*< Volts per meter/second. */
+  SimMechanismHelper::PIDConfig steerPID; /*< Volts per radian. */
+
+  // Passed to the `frc::HolonomicDriveController` following the path.
+  frc::PIDController xController{1.0, 0.0, 0.0};
+  frc::PIDController yController{1.0, 0.0, 0.0};
+  frc::ProfiledPIDController<units::radian> thetaController{
+      1.0, 0.0, 0.0, {6.28_rad_per_s, 3.14_rad_per_s_sq}};
+};
+
+/**
+ * How well one gain set followed the path, measured from the true simulated
+ * pose rather than odometry.
+ */
+struct Result {
+  units::meter_t rmsError = 0.0_m; /*< Position error while following. */
+  units::meter_t maxError = 0.0_m; /*< Position error while following. */
+  units::radian_t maxHeadingError = 0.0_rad; /*< While following. */
+  units::meter_t finalError = 0.0_m; /*< At the end of the settle window. */
+
+  /**
+   * Time after the path ends until the robot stayed within tolerance of the
+   * final pose. Negative if it never settled.
+   */
+  units::second_t settlingTime = -1.0_s;
+
+  size_t slipSteps = 0; /*< Loops in which any wheel slipped. */
+};
+
+} // namespace SwerveGainSweepHelper
+
+/**
+ * Tunes drivetrain gains headlessly by following a path with many simulated
+ * `SwerveDrive`s at once, one per gain set, spread across every CPU core.
+ *
+ * Each run builds its own `SwerveDrive` on simulated controllers, a
+ * `SwerveDriveSim`, a private NetworkTables instance and a simulated clock,
+ * and follows the path the way `SwerveDrive::followSampledTrajectory()` does
+ * without going through the command scheduler. Runs share no state, so they
+ * scale with the number of cores and give the same result however many
+ * threads are used.
+ *
+ * @tparam NumModules Number of swerve modules.
+ */
+template <size_t NumModules> class SwerveGainSweep {
+public:
+  struct CreateInfo {
+    std::array<SwerveGainSweepHelper::ModuleConfig, NumModules> modules;
+    typename SwerveDriveSim<NumModules>::ChassisConfig chassis;
+    units::meters_per_second_t maxModuleSpeed;
+    std::optional<SwerveSetpointLimits> setpointLimits;
+    units::second_t loopPeriod = 20_ms; /*< Period of the robot loop. */
+    units::second_t settleTime = 2.0_s; /*< Simulated after the path ends. */
+    units::meter_t positionTolerance = 0.05_m;   /*< For settling. */
+    units::radian_t headingTolerance = 0.05_rad; /*< For settling. */
+  };
+
+  explicit SwerveGainSweep(const CreateInfo &createInfo);
+
+  /**
+   * Follows a path once with every gain set.
+   *
+   * @param path     Path to follow, starting from its initial pose.
+   * @param gainSets Gains to try.
+   * @param threads  Number of threads to run on, or 0 for one per core.
+   *
+   * @return The result of each gain set, in the same order.
+   */
+  std::vector<SwerveGainSweepHelper::Result>
+  run(const SampledTrajectory &path,
+      const std::vector<SwerveGainSweepHelper::GainSet> &gainSets,
+      size_t threads = 0) const;
+
+  /**
+   * Follows a path with a single gain set on the calling thread.
+   */
+  SwerveGainSweepHelper::Result
+  runOne(const SampledTrajectory &path,
+         const SwerveGainSweepHelper::GainSet &gains) const;
+
+  /**
+   * Writes the results as a table, one row per gain set, best first by RMS
+   * error.
+   */
+  static void
+  printResults(std::ostream &out,
+               const std::vector<SwerveGainSweepHelper::Result> &results);
+
+private:
+  CreateInfo createInfo;
+};
+} // namespace rmb
+
+#include "SwerveGainSweep.inl"
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "rmb/drive/SwerveGainSweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+#include <frc/controller/HolonomicDriveController.h>
+#include <frc/geometry/Pose2d.h>
+#include <frc/trajectory/Trajectory.h>
+#include <networktables/NetworkTableInstance.h>
+
+#include "units/math.h"
+
+#include "rmb/drive/SwerveDrive.h"
+#include "rmb/drive/SwerveModule.h"
+#include "rmb/motorcontrol/sim/SimAngularPositionController.h"
+#include "rmb/motorcontrol/sim/SimLinearVelocityController.h"
+#include "rmb/sensors/sim/SimGyro.h"
+
+namespace rmb {
+
+template <size_t NumModules>
+SwerveGainSweep<NumModules>::SwerveGainSweep(const CreateInfo &createInfo)
+    : createInfo(createInfo) {}
+
+template <size_t NumModules>
+std::vector<SwerveGainSweepHelper::Result> SwerveGainSweep<NumModules>::run(
+    const SampledTrajectory &path,
+    const std::vector<SwerveGainSweepHelper::GainSet> &gainSets,
+    size_t threads) const {
+  std::vector<SwerveGainSweepHelper::Result> results(gainSets.size());
+
+  if (threads == 0) {
+    threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  threads = std::min(threads, gainSets.size());
+
+  // Runs vary in length, so hand out gain sets one at a time rather than
+  // splitting them evenly up front.
+  std::atomic<size_t> nextGainSet = 0;
+  auto runGainSets = [&]() {
+    size_t index;
+    while ((index = nextGainSet.fetch_add(1)) < gainSets.size()) {
+      results[index] = runOne(path, gainSets[index]);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; i++) {
+    workers.emplace_back(runGainSets);
+  }
+
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  return results;
+}
+
+template <size_t NumModules>
+SwerveGainSweepHelper::Result SwerveGainSweep<NumModules>::runOne(
+    const SampledTrajectory &path,
+    const SwerveGainSweepHelper::GainSet &gains) const {
+  SwerveGainSweepHelper::Result result;
+
+  // Everything below is created on this thread, so its mechanisms are only
+  // stepped by this run's simulator.
+  nt::NetworkTableInstance ntInstance = nt::NetworkTableInstance::Create();
+  {
+    units::second_t time = 0.0_s;
+
+    std::array<typename SwerveDriveSim<NumModules>::ModuleConfig, NumModules>
+        simModules;
+    auto makeModule = [&](size_t i) {
+      const SwerveGainSweepHelper::ModuleConfig &module =
+          createInfo.modules[i];
+
+      auto drive = std::make_unique<SimLinearVelocityController>(
+          SimLinearVelocityController::CreateInfo{
+              .motorConfig = module.driveMotor,
+              .pidConfig = gains.drivePID,
+              .encoderConfig = module.driveEncoder,
+              .conversion = module.wheelRadius / 1.0_rad});
+      auto steer = std::make_unique<SimAngularPositionController>(
+          SimAngularPositionController::CreateInfo{
+              .motorConfig = module.steerMotor,
+              .pidConfig = gains.steerPID,
+              .encoderConfig = module.steerEncoder,
+              .continuousWrap = true});
+
+      simModules[i] = {&drive->getMechanism(), &steer->getMechanism(),
+                       module.wheelRadius, module.translation};
+
+      return SwerveModule(std::move(drive), std::move(steer),
+                          module.translation, true);
+    };
+
+    std::array<SwerveModule, NumModules> modules =
+        [&]<size_t... Indices>(std::index_sequence<Indices...>) {
+          return std::array<SwerveModule, NumModules>{
+              makeModule(Indices)...};
+        }(std::make_index_sequence<NumModules>());
+
+    const units::second_t pathTime = path.getTotalTime();
+    const frc::Pose2d initialPose(path.getInitialPose().Translation(),
+                                  path.getTargetRotation(0.0_s));
+    const frc::Pose2d finalPose(path.getFinalPose().Translation(),
+                                path.getTargetRotation(pathTime));
+
+    auto gyro = std::make_shared<SimGyro>();
+    SwerveDriveSim<NumModules> sim(simModules, createInfo.chassis, gyro);
+    sim.resetPose(initialPose);
+
+    frc::HolonomicDriveController controller(
+        gains.xController, gains.yController, gains.thetaController);
+
+    SwerveDrive<NumModules> drive(std::move(modules), gyro, controller,
+                                  createInfo.maxModuleSpeed, initialPose,
+                                  {ntInstance, [&time]() { return time; }});
+    if (createInfo.setpointLimits) {
+      drive.setSetpointLimits(*createInfo.setpointLimits);
+    }
+
+    // Step by index so the loop count does not depend on rounding.
+    const size_t steps = static_cast<size_t>(std::ceil(
+        (pathTime + createInfo.settleTime) / createInfo.loopPeriod));
+
+    double squaredErrorSum = 0.0;
+    size_t followingSteps = 0;
+    std::optional<units::second_t> settledAt;
+
+    for (size_t step = 0; step <= steps; step++) {
+      time = step * createInfo.loopPeriod;
+
+      drive.sample();
+      drive.updatePose();
+
+      units::second_t t = units::math::min(time, pathTime);
+      frc::Trajectory::State state = path.sample(t);
+      frc::Rotation2d rotation = path.getTargetRotation(t);
+
+      frc::Pose2d pose = sim.getPose();
+      if (time < pathTime) {
+        units::meter_t error =
+            pose.Translation().Distance(state.pose.Translation());
+        units::radian_t headingError =
+            units::math::abs((pose.Rotation() - rotation).Radians());
+
+        squaredErrorSum += error.value() * error.value();
+        followingSteps++;
+        result.maxError = units::math::max(result.maxError, error);
+        result.maxHeadingError =
+            units::math::max(result.maxHeadingError, headingError);
+      } else {
+        result.finalError =
+            pose.Translation().Distance(finalPose.Translation());
+        units::radian_t headingError = units::math::abs(
+            (pose.Rotation() - finalPose.Rotation()).Radians());
+
+        if (result.finalError > createInfo.positionTolerance ||
+            headingError > createInfo.headingTolerance) {
+          settledAt.reset();
+        } else if (!settledAt) {
+          settledAt = time - pathTime;
+        }
+      }
+
+      if (step == steps) {
+        break;
+      }
+
+      drive.driveChassisSpeeds(
+          controller.Calculate(drive.getPose(), state, rotation));
+      sim.update(createInfo.loopPeriod);
+
+      for (size_t i = 0; i < NumModules; i++) {
+        if (sim.isSlipping(i)) {
+          result.slipSteps++;
+          break;
+        }
+      }
+    }
+
+    if (followingSteps > 0) {
+      result.rmsError = units::meter_t(
+          std::sqrt(squaredErrorSum / static_cast<double>(followingSteps)));
+    }
+    result.settlingTime = settledAt.value_or(-1.0_s);
+  }
+  nt::NetworkTableInstance::Destroy(ntInstance);
+
+  return result;
+}
+
+template <size_t NumModules>
+void SwerveGainSweep<NumModules>::printResults(
+    std::ostream &out,
+    const std::vector<SwerveGainSweepHelper::Result> &results) {
+  std::vector<size_t> order(results.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return results[a].rmsError < results[b].rmsError;
+  });
+
+  out << std::setw(6) << "set" << std::setw(10) << "rms (m)" << std::setw(10)
+      << "max (m)" << std::setw(12) << "max (rad)" << std::setw(11)
+      << "final (m)" << std::setw(12) << "settle (s)" << std::setw(7)
+      << "slip" << '\n';
+
+  out << std::fixed << std::setprecision(3);
+  for (size_t index : order) {
+    const SwerveGainSweepHelper::Result &result = results[index];
+
+    out << std::setw(6) << index << std::setw(10) << result.rmsError.value()
+        << std::setw(10) << result.maxError.value() << std::setw(12)
+        << result.maxHeadingError.value() << std::setw(11)
+        << result.finalError.value() << std::setw(12);
+    if (result.settlingTime < 0.0_s) {
+      out << "never";
+    } else {
+      out << result.settlingTime.value();
+    }
+    out << std::setw(7) << result.slipSteps << '\n';
+  }
+}
+
+} // namespace rmb
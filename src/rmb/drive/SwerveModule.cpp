@@ -2,6 +2,7 @@
 #include "frc/kinematics/SwerveModulePosition.h"
 #include "frc/kinematics/SwerveModuleState.h"
 #include "frc/smartdashboard/SmartDashboard.h"
+#include "rmb/util/Profiler.h"
 
 #include "units/angle.h"
 #include "units/velocity.h"
@@ -38,12 +39,13 @@ void SwerveModule::setState(const units::meters_per_second_t &velocity,
 }
 
 void SwerveModule::setState(const frc::SwerveModuleState &state) {
-  // units::millisecond_t start = frc::Timer::GetFPGATimestamp();
-  auto optomized = frc::SwerveModuleState::Optimize(state, getState().angle);
-  // std::cout << "optimize time: "
-  //           << ((units::millisecond_t)frc::Timer::GetFPGATimestamp() -
-  //           start)()
-  //           << std::endl;
+  setState(state, frc::Rotation2d(angularController->getPosition()));
+}
+
+void SwerveModule::setState(const frc::SwerveModuleState &state,
+                            const frc::Rotation2d &currentAngle) {
+  RMB_PROFILE_ZONE("SwerveModule::setState");
+  auto optomized = frc::SwerveModuleState::Optimize(state, currentAngle);
   velocityController->setVelocity(optomized.speed);
   angularController->setPosition(optomized.angle.Radians());
 }
@@ -82,6 +84,16 @@ frc::SwerveModulePosition SwerveModule::getPosition() const {
           frc::Rotation2d(angularController->getPosition())};
 }
 
+SwerveModuleSample SwerveModule::sample() const {
+  frc::Rotation2d angle(angularController->getPosition());
+
+  return {.state = {velocityController->getVelocity(), angle},
+          .position = {velocityController->getPosition(), angle},
+          .targetState = {velocityController->getTargetVelocity(),
+                          frc::Rotation2d(
+                              angularController->getTargetPosition())}};
+}
+
 frc::SwerveModuleState SwerveModule::getTargetState() const {
   return {velocityController->getTargetVelocity(),
           frc::Rotation2d(angularController->getTargetPosition())};
@@ -45,6 +45,16 @@ struct SwerveModulePower {
                                     const frc::Rotation2d &currentAngle);
 };
 
+/**
+ * Measured and target values of a swerve module read together at a single
+ * point in time.
+ */
+struct SwerveModuleSample {
+  frc::SwerveModuleState state;       /* <- Measured velocity and angle. */
+  frc::SwerveModulePosition position; /* <- Measured distance and angle. */
+  frc::SwerveModuleState targetState; /* <- Target velocity and angle. */
+};
+
 /**
  * Class managing the motion of a swerve module
  */
@@ -85,6 +95,17 @@ public:
    */
   void setState(const frc::SwerveModuleState &state);
 
+  /**
+   * Sets the desired state of the swerve module using an already measured
+   * module angle for optimization rather than reading it from the angular
+   * controller again.
+   *
+   * @param state        The desired state of the module.
+   * @param currentAngle The most recently measured angle of the module.
+   */
+  void setState(const frc::SwerveModuleState &state,
+                const frc::Rotation2d &currentAngle);
+
   /**
    * Returns the current state of the module.
    */
@@ -96,6 +117,13 @@ public:
    */
   frc::SwerveModulePosition getPosition() const;
 
+  /**
+   * Reads the measured state, position and target state of the module in one
+   * pass. The module angle is only read once and shared between the state and
+   * position.
+   */
+  SwerveModuleSample sample() const;
+
   /**
    * @return The target state of the module. This is useful for debugging.
    */
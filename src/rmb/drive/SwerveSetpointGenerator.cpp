@@ -0,0 +1,5 @@
+#include "SwerveSetpointGenerator.h"
+
+namespace rmb {
+template class rmb::SwerveSetpointGenerator<4>;
+}
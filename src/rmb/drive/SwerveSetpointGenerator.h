@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <Eigen/Core>
+
+#include <frc/geometry/Rotation2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <frc/kinematics/SwerveModuleState.h>
+
+#include "units/acceleration.h"
+#include "units/angular_velocity.h"
+#include "units/time.h"
+#include "units/velocity.h"
+
+namespace rmb {
+
+/**
+ * Physical limits of a swerve module used by `SwerveSetpointGenerator`.
+ */
+struct SwerveSetpointLimits {
+  /**
+   * Largest change in wheel speed a module can make per second.
+   */
+  units::meters_per_second_squared_t maxDriveAcceleration;
+
+  /**
+   * Fastest a module can rotate about its steering axis.
+   */
+  units::radians_per_second_t maxSteerVelocity;
+};
+
+/**
+ * Chassis speeds and the module states that produce them, as commanded on a
+ * single loop.
+ *
+ * @tparam NumModules Number of swerve modules on the drivetrain.
+ */
+template <size_t NumModules> struct SwerveSetpoint {
+  frc::ChassisSpeeds chassisSpeeds; /* <- Robot relative. */
+  std::array<frc::SwerveModuleState, NumModules> moduleStates;
+};
+
+/**
+ * Limits how quickly a swerve drive's setpoint may change so every module
+ * command is one the hardware can actually reach by the next loop.
+ *
+ * Each call moves from the previous setpoint toward the requested chassis
+ * speeds only as far as every module can follow without exceeding its drive
+ * acceleration or steering rate. Since the chassis speeds are interpolated
+ * rather than each module being limited on its own, the modules always agree
+ * on a single rigid body motion and do not scrub against each other.
+ *
+ * @tparam NumModules Number of swerve modules on the drivetrain.
+ */
+template <size_t NumModules> class SwerveSetpointGenerator {
+public:
+  /**
+   * Constructs a SwerveSetpointGenerator.
+   *
+   * @param moduleTranslations Position of each module reletive to the center
+   *                           of the robot.
+   * @param maxModuleSpeed     Fastest any module can drive. Requests are
+   *                           scaled down to respect it.
+   * @param limits             Acceleration and steering limits of the
+   *                           modules.
+   */
+  SwerveSetpointGenerator(
+      const std::array<frc::Translation2d, NumModules> &moduleTranslations,
+      units::meters_per_second_t maxModuleSpeed,
+      const SwerveSetpointLimits &limits);
+
+  /**
+   * Returns the setpoint closest to `desired` that can be reached from
+   * `previous` within `dt`.
+   *
+   * @param previous The setpoint returned on the previous loop, or the
+   *                 measured state of the drive when there is none.
+   * @param desired  Robot relative chassis speeds to move toward.
+   * @param dt       Time until the next setpoint will be generated.
+   *
+   * @return The feasible setpoint to command this loop.
+   */
+  SwerveSetpoint<NumModules>
+  generate(const SwerveSetpoint<NumModules> &previous,
+           frc::ChassisSpeeds desired, units::second_t dt) const;
+
+  const SwerveSetpointLimits &getLimits() const { return limits; }
+
+private:
+  /**
+   * Rotation and signed wheel speed needed to take a module from its current
+   * angle to a velocity, reversing the wheel whenever that is the shorter
+   * rotation.
+   */
+  struct ModuleChange {
+    double steer; /* <- Radians, within [-pi/2, pi/2]. */
+    double speed; /* <- Meters per second along the new angle. */
+  };
+
+  /**
+   * Returns the velocity (in meters per second) of module `index` when the
+   * robot moves at `speeds`.
+   */
+  Eigen::Vector2d getModuleVelocity(const frc::ChassisSpeeds &speeds,
+                                    size_t index) const;
+
+  static ModuleChange getModuleChange(const Eigen::Vector2d &velocity,
+                                      const frc::Rotation2d &currentAngle);
+
+  static frc::ChassisSpeeds interpolate(const frc::ChassisSpeeds &start,
+                                        const frc::ChassisSpeeds &end,
+                                        double t);
+
+  std::array<frc::Translation2d, NumModules> moduleTranslations;
+  units::meters_per_second_t maxModuleSpeed;
+  SwerveSetpointLimits limits;
+};
+} // namespace rmb
+
+#include "SwerveSetpointGenerator.inl"
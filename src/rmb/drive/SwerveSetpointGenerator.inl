@@ -0,0 +1,152 @@
+#pragma once
+
+#include "rmb/drive/SwerveSetpointGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace rmb {
+
+/**
+ * Modules moving slower than this (in meters per second) are treated as
+ * stopped and may be pointed in any direction.
+ */
+inline constexpr double kSwerveSetpointStoppedSpeed = 1e-3;
+
+/**
+ * Number of bisection steps used to find how far toward the request the
+ * drive can move. Resolves to better than 0.1% of the request.
+ */
+inline constexpr int kSwerveSetpointIterations = 10;
+
+template <size_t NumModules>
+SwerveSetpointGenerator<NumModules>::SwerveSetpointGenerator(
+    const std::array<frc::Translation2d, NumModules> &moduleTranslations,
+    units::meters_per_second_t maxModuleSpeed,
+    const SwerveSetpointLimits &limits)
+    : moduleTranslations(moduleTranslations), maxModuleSpeed(maxModuleSpeed),
+      limits(limits) {}
+
+template <size_t NumModules>
+SwerveSetpoint<NumModules> SwerveSetpointGenerator<NumModules>::generate(
+    const SwerveSetpoint<NumModules> &previous, frc::ChassisSpeeds desired,
+    units::second_t dt) const {
+
+  // Scale the request down until no module has to exceed its top speed.
+  double largestSpeed = 0.0;
+  for (size_t i = 0; i < NumModules; i++) {
+    largestSpeed = std::max(largestSpeed, getModuleVelocity(desired, i).norm());
+  }
+
+  if (largestSpeed > maxModuleSpeed()) {
+    double scale = maxModuleSpeed() / largestSpeed;
+    desired = frc::ChassisSpeeds{desired.vx * scale, desired.vy * scale,
+                                 desired.omega * scale};
+  }
+
+  const double maxSpeedChange =
+      units::meters_per_second_t(limits.maxDriveAcceleration * dt)();
+  const double maxSteerChange = units::radian_t(limits.maxSteerVelocity * dt)();
+
+  auto isReachable = [&](double t) {
+    frc::ChassisSpeeds speeds = interpolate(previous.chassisSpeeds, desired, t);
+
+    for (size_t i = 0; i < NumModules; i++) {
+      const frc::SwerveModuleState &current = previous.moduleStates[i];
+      ModuleChange change =
+          getModuleChange(getModuleVelocity(speeds, i), current.angle);
+
+      if (std::abs(change.speed - current.speed()) > maxSpeedChange ||
+          std::abs(change.steer) > maxSteerChange) {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  // The modules' velocities are linear in t, so bisect for the furthest
+  // fraction of the way to the request every module can follow.
+  double reachable = 1.0;
+  if (!isReachable(reachable)) {
+    double lower = 0.0;
+    double upper = 1.0;
+    for (int i = 0; i < kSwerveSetpointIterations; i++) {
+      double middle = (lower + upper) / 2.0;
+      if (isReachable(middle)) {
+        lower = middle;
+      } else {
+        upper = middle;
+      }
+    }
+    reachable = lower;
+  }
+
+  SwerveSetpoint<NumModules> setpoint;
+  setpoint.chassisSpeeds =
+      interpolate(previous.chassisSpeeds, desired, reachable);
+
+  for (size_t i = 0; i < NumModules; i++) {
+    const frc::Rotation2d &currentAngle = previous.moduleStates[i].angle;
+    Eigen::Vector2d velocity = getModuleVelocity(setpoint.chassisSpeeds, i);
+    ModuleChange change = getModuleChange(velocity, currentAngle);
+
+    // A stopped module turns toward where it is about to drive so it is
+    // aligned by the time the drive can accelerate it.
+    if (velocity.norm() < kSwerveSetpointStoppedSpeed) {
+      change.steer =
+          getModuleChange(getModuleVelocity(desired, i), currentAngle).steer;
+    }
+
+    double steer = std::clamp(change.steer, -maxSteerChange, maxSteerChange);
+    setpoint.moduleStates[i] = frc::SwerveModuleState{
+        units::meters_per_second_t(change.speed),
+        currentAngle + frc::Rotation2d(units::radian_t(steer))};
+  }
+
+  return setpoint;
+}
+
+template <size_t NumModules>
+Eigen::Vector2d SwerveSetpointGenerator<NumModules>::getModuleVelocity(
+    const frc::ChassisSpeeds &speeds, size_t index) const {
+  const frc::Translation2d &translation = moduleTranslations[index];
+  return Eigen::Vector2d{
+      speeds.vx() - speeds.omega() * translation.Y()(),
+      speeds.vy() + speeds.omega() * translation.X()()};
+}
+
+template <size_t NumModules>
+typename SwerveSetpointGenerator<NumModules>::ModuleChange
+SwerveSetpointGenerator<NumModules>::getModuleChange(
+    const Eigen::Vector2d &velocity, const frc::Rotation2d &currentAngle) {
+  double speed = velocity.norm();
+  if (speed < kSwerveSetpointStoppedSpeed) {
+    return ModuleChange{0.0, 0.0};
+  }
+
+  frc::Rotation2d angle{
+      units::radian_t(std::atan2(velocity.y(), velocity.x()))};
+  double steer = (angle - currentAngle).Radians()();
+
+  if (steer > std::numbers::pi / 2.0) {
+    return ModuleChange{steer - std::numbers::pi, -speed};
+  }
+
+  if (steer < -std::numbers::pi / 2.0) {
+    return ModuleChange{steer + std::numbers::pi, -speed};
+  }
+
+  return ModuleChange{steer, speed};
+}
+
+template <size_t NumModules>
+frc::ChassisSpeeds SwerveSetpointGenerator<NumModules>::interpolate(
+    const frc::ChassisSpeeds &start, const frc::ChassisSpeeds &end, double t) {
+  return frc::ChassisSpeeds{start.vx + (end.vx - start.vx) * t,
+                            start.vy + (end.vy - start.vy) * t,
+                            start.omega + (end.omega - start.omega) * t};
+}
+
+} // namespace rmb
@@ -0,0 +1,72 @@
+#include "rmb/drive/SwerveTelemetry.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rmb {
+
+SwerveTelemetryPublisher::SwerveTelemetryPublisher(nt::NetworkTable &table,
+                                                   std::string_view topic,
+                                                   size_t numModules)
+    : publisher(table.GetStructArrayTopic<SwerveModuleTelemetry>(topic)
+                    .Publish()),
+      lastPublished(numModules) {}
+
+bool SwerveTelemetryPublisher::publish(
+    std::span<const SwerveModuleTelemetry> modules, units::second_t timestamp) {
+  if (hasPublished && timestamp - lastPublishTime < period) {
+    return false;
+  }
+
+  if (hasPublished && !hasChanged(modules)) {
+    return false;
+  }
+
+  publisher.Set(modules);
+  std::copy(modules.begin(), modules.end(), lastPublished.begin());
+  lastPublishTime = timestamp;
+  hasPublished = true;
+
+  return true;
+}
+
+bool SwerveTelemetryPublisher::hasChanged(
+    std::span<const SwerveModuleTelemetry> modules) const {
+  for (size_t i = 0; i < modules.size(); i++) {
+    const SwerveModuleTelemetry &current = modules[i];
+    const SwerveModuleTelemetry &last = lastPublished[i];
+
+    for (auto field : {&SwerveModuleTelemetry::position,
+                       &SwerveModuleTelemetry::velocity,
+                       &SwerveModuleTelemetry::targetPosition,
+                       &SwerveModuleTelemetry::targetVelocity,
+                       &SwerveModuleTelemetry::positionError,
+                       &SwerveModuleTelemetry::velocityError}) {
+      if (std::abs(current.*field - last.*field) > deadband) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+} // namespace rmb
+
+rmb::SwerveModuleTelemetry wpi::Struct<rmb::SwerveModuleTelemetry>::Unpack(
+    std::span<const uint8_t> data) {
+  return rmb::SwerveModuleTelemetry{
+      wpi::UnpackStruct<double, 0>(data),  wpi::UnpackStruct<double, 8>(data),
+      wpi::UnpackStruct<double, 16>(data), wpi::UnpackStruct<double, 24>(data),
+      wpi::UnpackStruct<double, 32>(data), wpi::UnpackStruct<double, 40>(data)};
+}
+
+void wpi::Struct<rmb::SwerveModuleTelemetry>::Pack(
+    std::span<uint8_t> data, const rmb::SwerveModuleTelemetry &value) {
+  wpi::PackStruct<0>(data, value.position);
+  wpi::PackStruct<8>(data, value.velocity);
+  wpi::PackStruct<16>(data, value.targetPosition);
+  wpi::PackStruct<24>(data, value.targetVelocity);
+  wpi::PackStruct<32>(data, value.positionError);
+  wpi::PackStruct<40>(data, value.velocityError);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <networktables/NetworkTable.h>
+#include <networktables/StructArrayTopic.h>
+
+#include <wpi/struct/Struct.h>
+
+#include "units/time.h"
+
+namespace rmb {
+
+/**
+ * Measurements, targets and errors of one swerve module, published together
+ * so a dashboard always sees values from the same loop. Angles are in turns
+ * and velocities in meters per second (or power when driving open loop).
+ */
+struct SwerveModuleTelemetry {
+  double position = 0.0;       /* <- Measured module angle. */
+  double velocity = 0.0;       /* <- Measured wheel velocity. */
+  double targetPosition = 0.0; /* <- Commanded module angle. */
+  double targetVelocity = 0.0; /* <- Commanded velocity or power. */
+  double positionError = 0.0;  /* <- Commanded minus measured angle. */
+  double velocityError = 0.0;  /* <- Commanded minus measured velocity. */
+};
+
+/**
+ * Publishes the telemetry of every module of a drive as a single struct
+ * array topic.
+ *
+ * Publishing is rate limited independently of how often `publish()` is
+ * called, and is skipped entirely when no value has moved by more than a
+ * deadband since the last publish, so an idle or slowly moving drive costs
+ * next to no bandwidth.
+ */
+class SwerveTelemetryPublisher {
+public:
+  /**
+   * Constructs a SwerveTelemetryPublisher.
+   *
+   * @param table      Table to publish to.
+   * @param topic      Name of the struct array topic within `table`.
+   * @param numModules Number of modules on the drive.
+   */
+  SwerveTelemetryPublisher(nt::NetworkTable &table, std::string_view topic,
+                           size_t numModules);
+
+  /**
+   * Publishes the telemetry if the period has elapsed since the last publish
+   * and any value changed by more than the deadband.
+   *
+   * @param modules   Telemetry of each module, `numModules` long.
+   * @param timestamp Current FPGA time.
+   *
+   * @return Whether the telemetry was published.
+   */
+  bool publish(std::span<const SwerveModuleTelemetry> modules,
+               units::second_t timestamp);
+
+  /**
+   * Sets the shortest time between publishes. Zero publishes on every call.
+   */
+  void setPeriod(units::second_t period) { this->period = period; }
+
+  /**
+   * Sets how far any value must move from the last published value before
+   * it is published again. Zero publishes whenever anything changes.
+   */
+  void setDeadband(double deadband) { this->deadband = deadband; }
+
+private:
+  /**
+   * Returns whether any value differs from the last published one by more
+   * than the deadband.
+   */
+  bool hasChanged(std::span<const SwerveModuleTelemetry> modules) const;
+
+  nt::StructArrayPublisher<SwerveModuleTelemetry> publisher;
+
+  std::vector<SwerveModuleTelemetry> lastPublished;
+  units::second_t lastPublishTime = 0.0_s;
+  bool hasPublished = false;
+
+  units::second_t period = 0.1_s;
+  double deadband = 1e-3;
+};
+} // namespace rmb
+
+template <> struct wpi::Struct<rmb::SwerveModuleTelemetry> {
+  static constexpr std::string_view GetTypeString() {
+    return "struct:SwerveModuleTelemetry";
+  }
+  static constexpr size_t GetSize() { return 48; }
+  static constexpr std::string_view GetSchema() {
+    return "double position;double velocity;double targetPosition;"
+           "double targetVelocity;double positionError;double velocityError";
+  }
+
+  static rmb::SwerveModuleTelemetry Unpack(std::span<const uint8_t> data);
+  static void Pack(std::span<uint8_t> data,
+                   const rmb::SwerveModuleTelemetry &value);
+};
@@ -0,0 +1,94 @@
+#include "rmb/drive/VisionGate.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/LU>
+
+#include <frc/MathUtil.h>
+
+namespace rmb {
+
+VisionGate::VisionGate(const VisionGateHelper::Config &config)
+    : config(config) {
+  const wpi::array<double, 3> &stdDevs = config.estimateStdDevs;
+  estimateCovariance =
+      Eigen::Vector3d(stdDevs[0] * stdDevs[0], stdDevs[1] * stdDevs[1],
+                      stdDevs[2] * stdDevs[2])
+          .asDiagonal();
+}
+
+std::optional<wpi::array<double, 3>>
+VisionGate::evaluate(const VisionMeasurement &measurement,
+                     const std::optional<frc::Pose2d> &estimate,
+                     const std::optional<Eigen::Matrix3d> &covariance,
+                     const frc::ChassisSpeeds &speeds) {
+  if (!estimate) {
+    statistics.rejectedStale++;
+    return std::nullopt;
+  }
+
+  if (measurement.tagCount == 1 &&
+      measurement.ambiguity > config.maxAmbiguity) {
+    statistics.rejectedAmbiguity++;
+    return std::nullopt;
+  }
+
+  wpi::array<double, 3> stdDevs = getStdDevs(measurement, speeds);
+
+  Eigen::Vector3d residual(
+      (measurement.pose.X() - estimate->X()).value(),
+      (measurement.pose.Y() - estimate->Y()).value(),
+      frc::AngleModulus(measurement.pose.Rotation().Radians() -
+                        estimate->Rotation().Radians())
+          .value());
+
+  Eigen::Matrix3d innovationCovariance =
+      covariance.value_or(estimateCovariance);
+  for (int i = 0; i < 3; i++) {
+    innovationCovariance(i, i) += stdDevs[i] * stdDevs[i];
+  }
+
+  statistics.lastDistance =
+      residual.dot(innovationCovariance.inverse() * residual);
+
+  if (statistics.lastDistance > config.gateThreshold) {
+    if (++consecutiveOutliers <= config.maxConsecutiveOutliers) {
+      statistics.rejectedOutlier++;
+      return std::nullopt;
+    }
+
+    // Vision has disagreed for long enough that the estimate is more likely
+    // wrong than every camera.
+    statistics.forcedAccepts++;
+  } else {
+    statistics.accepted++;
+  }
+
+  consecutiveOutliers = 0;
+  return stdDevs;
+}
+
+wpi::array<double, 3>
+VisionGate::getStdDevs(const VisionMeasurement &measurement,
+                       const frc::ChassisSpeeds &speeds) const {
+  if (measurement.stdDevs) {
+    return *measurement.stdDevs;
+  }
+
+  double distance = std::max(
+      (measurement.tagDistance / config.referenceDistance).value(), 1.0);
+  double speed = std::hypot(speeds.vx.value(), speeds.vy.value());
+
+  // More tags constrain the solve more. Motion blurs the image and makes
+  // the capture timestamp matter more.
+  double scale = distance * distance /
+                 static_cast<double>(std::max(measurement.tagCount, 1)) *
+                 (1.0 + config.linearSpeedFactor * speed +
+                  config.angularSpeedFactor * std::abs(speeds.omega.value()));
+
+  return {config.baseStdDevs[0] * scale, config.baseStdDevs[1] * scale,
+          config.baseStdDevs[2] * scale};
+}
+
+} // namespace rmb
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <Eigen/Core>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <wpi/array.h>
+
+#include "units/length.h"
+
+#include "rmb/drive/BaseDrive.h"
+
+namespace rmb {
+
+namespace VisionGateHelper {
+
+struct Config {
+  /**
+   * Largest squared Mahalanobis distance of a measurement from the estimate
+   * that is accepted. 11.34 accepts 99% of consistent measurements, since
+   * the squared distance of a 3D pose follows a chi-squared distribution
+   * with three degrees of freedom.
+   */
+  double gateThreshold = 11.34;
+
+  /**
+   * Standard deviations of a single tag measurement at `referenceDistance`
+   * from a stationary robot, ordered X, Y (meters) and Theta (radians).
+   */
+  wpi::array<double, 3> baseStdDevs{0.3, 0.3, 0.6};
+
+  /** Standard deviations grow with the square of the distance past this. */
+  units::meter_t referenceDistance = 1.0_m;
+
+  /** Growth of the standard deviations per m/s the robot is moving. */
+  double linearSpeedFactor = 0.5;
+
+  /** Growth of the standard deviations per rad/s the robot is turning. */
+  double angularSpeedFactor = 1.0;
+
+  /** Single tag measurements more ambiguous than this are rejected. */
+  double maxAmbiguity = 0.2;
+
+  /**
+   * Uncertainty of the estimate, ordered X, Y (meters) and Theta (radians),
+   * used with estimators that do not track their own covariance.
+   */
+  wpi::array<double, 3> estimateStdDevs{0.1, 0.1, 0.1};
+
+  /**
+   * After this many outliers in a row the next measurement is accepted
+   * anyway, so a bad estimate can not lock vision out forever.
+   */
+  size_t maxConsecutiveOutliers = 25;
+};
+
+/**
+ * Counts of every measurement the gate has evaluated.
+ */
+struct Statistics {
+  size_t accepted = 0;
+  size_t rejectedOutlier = 0;   /*< Too far from the estimate. */
+  size_t rejectedAmbiguity = 0; /*< Ambiguous single tag solve. */
+  size_t rejectedStale = 0;     /*< Older than the recorded estimates. */
+  size_t forcedAccepts = 0;     /*< Outliers accepted to resynchronize. */
+
+  /** Squared Mahalanobis distance of the last measurement evaluated. */
+  double lastDistance = 0.0;
+};
+
+} // namespace VisionGateHelper
+
+/**
+ * Screens vision measurements before they reach a pose estimator.
+ *
+ * Each measurement's standard deviations are scaled by the distance to its
+ * tags, the number of tags and how fast the robot is moving, unless the
+ * camera already reported its own. The measurement is then compared with
+ * the estimate at the time it was captured. Ones further than the gate
+ * threshold, measured in standard deviations of the combined estimate and
+ * measurement uncertainty, are rejected as outliers.
+ *
+ * This class is not synchronized. Users sharing it between threads must lock
+ * around it.
+ */
+class VisionGate {
+public:
+  explicit VisionGate(const VisionGateHelper::Config &config);
+
+  /**
+   * Decides whether to apply a measurement.
+   *
+   * @param measurement The measurement.
+   * @param estimate    Estimated pose when the measurement was captured, or
+   *                    nothing if it is older than the recorded estimates.
+   * @param covariance  Covariance of the estimate's X, Y and Theta, or
+   *                    nothing to use `Config::estimateStdDevs`.
+   * @param speeds      Robot relative speeds of the robot.
+   *
+   * @return Standard deviations to apply the measurement with, or nothing if
+   *         it was rejected.
+   */
+  std::optional<wpi::array<double, 3>>
+  evaluate(const VisionMeasurement &measurement,
+           const std::optional<frc::Pose2d> &estimate,
+           const std::optional<Eigen::Matrix3d> &covariance,
+           const frc::ChassisSpeeds &speeds);
+
+  /**
+   * Returns the standard deviations a measurement would be applied with.
+   */
+  wpi::array<double, 3> getStdDevs(const VisionMeasurement &measurement,
+                                   const frc::ChassisSpeeds &speeds) const;
+
+  const VisionGateHelper::Statistics &getStatistics() const {
+    return statistics;
+  }
+
+  void resetStatistics() { statistics = {}; }
+
+private:
+  VisionGateHelper::Config config;
+  Eigen::Matrix3d estimateCovariance;
+
+  VisionGateHelper::Statistics statistics;
+  size_t consecutiveOutliers = 0;
+};
+} // namespace rmb
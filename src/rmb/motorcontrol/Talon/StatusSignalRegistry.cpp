@@ -0,0 +1,52 @@
+#include "StatusSignalRegistry.h"
+
+#include <algorithm>
+
+#include "frc/Timer.h"
+
+#include "rmb/util/Profiler.h"
+
+namespace rmb {
+
+void StatusSignalRegistry::addSignals(
+    std::initializer_list<ctre::phoenix6::BaseStatusSignal *> newSignals) {
+  std::lock_guard<std::mutex> lock(signalMutex);
+  for (ctre::phoenix6::BaseStatusSignal *signal : newSignals) {
+    if (std::find(signals.begin(), signals.end(), signal) == signals.end()) {
+      signals.push_back(signal);
+    }
+  }
+}
+
+void StatusSignalRegistry::removeSignals(
+    std::initializer_list<ctre::phoenix6::BaseStatusSignal *> oldSignals) {
+  std::lock_guard<std::mutex> lock(signalMutex);
+  for (ctre::phoenix6::BaseStatusSignal *signal : oldSignals) {
+    signals.erase(std::remove(signals.begin(), signals.end(), signal),
+                  signals.end());
+  }
+}
+
+ctre::phoenix::StatusCode StatusSignalRegistry::refreshAll() {
+  RMB_PROFILE_ZONE("StatusSignalRegistry::refreshAll");
+  std::lock_guard<std::mutex> lock(signalMutex);
+  lastRefreshTime = frc::Timer::GetFPGATimestamp();
+
+  if (signals.empty()) {
+    return ctre::phoenix::StatusCode::OK;
+  }
+
+  return ctre::phoenix6::BaseStatusSignal::RefreshAll(signals);
+}
+
+units::second_t StatusSignalRegistry::getLastRefreshTime() const {
+  std::lock_guard<std::mutex> lock(signalMutex);
+  return lastRefreshTime;
+}
+
+size_t StatusSignalRegistry::size() const {
+  std::lock_guard<std::mutex> lock(signalMutex);
+  return signals.size();
+}
+
+} // namespace rmb
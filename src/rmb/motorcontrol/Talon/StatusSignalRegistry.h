@@ -0,0 +1,69 @@
+#pragma once
+
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+#include <ctre/phoenix6/StatusSignal.hpp>
+
+#include "units/time.h"
+
+namespace rmb {
+
+/**
+ * Collection of Phoenix 6 status signals that are refreshed together.
+ *
+ * TalonFX controllers (and their optional CANcoders) given a registry in their
+ * `CreateInfo` register their position and velocity signals here instead of
+ * refreshing them individually inside every getter. Calling `refreshAll()`
+ * once per robot loop reads every registered signal in a single batched call
+ * so all of them are time aligned, after which the controller getters just
+ * return the cached values.
+ */
+class StatusSignalRegistry {
+public:
+  StatusSignalRegistry() = default;
+  StatusSignalRegistry(const StatusSignalRegistry &) = delete;
+  StatusSignalRegistry(StatusSignalRegistry &&) = delete;
+
+  /**
+   * Adds signals to be refreshed by `refreshAll()`.
+   *
+   * @param signals Signals to add. They must outlive their registration.
+   */
+  void
+  addSignals(std::initializer_list<ctre::phoenix6::BaseStatusSignal *> signals);
+
+  /**
+   * Stops refreshing the given signals. Should be called before the device
+   * owning the signals is destroyed.
+   *
+   * @param signals Signals to remove.
+   */
+  void removeSignals(
+      std::initializer_list<ctre::phoenix6::BaseStatusSignal *> signals);
+
+  /**
+   * Refreshes every registered signal with a single batched call.
+   *
+   * @return The status of the refresh. Anything other than OK means at least
+   *         one signal could not be refreshed and still holds stale data.
+   */
+  ctre::phoenix::StatusCode refreshAll();
+
+  /**
+   * Returns the FPGA time of the most recent call to `refreshAll()`.
+   */
+  units::second_t getLastRefreshTime() const;
+
+  /**
+   * Returns the number of signals refreshed by `refreshAll()`.
+   */
+  size_t size() const;
+
+private:
+  mutable std::mutex signalMutex;
+  std::vector<ctre::phoenix6::BaseStatusSignal *> signals;
+  units::second_t lastRefreshTime = 0.0_s;
+};
+} // namespace rmb
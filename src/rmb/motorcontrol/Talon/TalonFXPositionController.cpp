@@ -2,16 +2,23 @@
 #include "ctre/phoenix6/configs/Configs.hpp"
 #include "ctre/phoenix6/core/CoreCANcoder.hpp"
 #include "ctre/phoenix6/core/CoreTalonFX.hpp"
+#include "rmb/util/Profiler.h"
 #include "units/angle.h"
 
 #include <iostream>
+#include <string>
 
 namespace rmb {
 
 TalonFXPositionController::TalonFXPositionController(
     const TalonFXPositionController::CreateInfo &createInfo)
     : motorcontroller(createInfo.config.id), range(createInfo.range),
-      usingCANCoder(createInfo.canCoderConfig.has_value()) {
+      usingCANCoder(createInfo.canCoderConfig.has_value()),
+      signalRegistry(createInfo.signalRegistry),
+      setpointLog(createInfo.recorder,
+                  "talonfx/" + std::to_string(createInfo.config.id) +
+                      "/setpoint",
+                  "mode (0 power, 1 position), setpoint (power or rad)") {
 
   ctre::phoenix6::configs::TalonFXConfiguration talonFXConfig{};
 
@@ -111,9 +118,28 @@ TalonFXPositionController::TalonFXPositionController(
 
   sensorToMechanismRatio = createInfo.feedbackConfig.sensorToMechanismRatio;
   // tolerance = createInfo.pidConfig.tolerance;
+
+  if (usingCANCoder) {
+    positionSignal = &canCoder->GetPosition();
+    velocitySignal = &canCoder->GetVelocity();
+  } else {
+    positionSignal = &motorcontroller.GetPosition();
+    velocitySignal = &motorcontroller.GetVelocity();
+  }
+
+  if (signalRegistry) {
+    signalRegistry->addSignals({positionSignal, velocitySignal});
+  }
+}
+
+TalonFXPositionController::~TalonFXPositionController() {
+  if (signalRegistry) {
+    signalRegistry->removeSignals({positionSignal, velocitySignal});
+  }
 }
 
 void TalonFXPositionController::setPosition(units::radian_t position) {
+  RMB_PROFILE_ZONE("TalonFXPositionController::setPosition");
   units::radian_t targetPosition(position);
 
   targetPosition =
@@ -122,6 +148,7 @@ void TalonFXPositionController::setPosition(units::radian_t position) {
   ctre::phoenix6::controls::PositionDutyCycle request(targetPosition);
 
   motorcontroller.SetControl(request);
+  setpointLog.record({1.0, targetPosition()});
 }
 
 units::radian_t TalonFXPositionController::getTargetPosition() const {
@@ -141,19 +168,28 @@ void TalonFXPositionController::disable() { motorcontroller.Disable(); }
 void TalonFXPositionController::stop() { motorcontroller.StopMotor(); }
 
 units::radians_per_second_t TalonFXPositionController::getVelocity() const {
-  if (usingCANCoder) {
-    return canCoder->GetVelocity().GetValue();
-  } else {
-    return motorcontroller.GetVelocity().GetValue();
+  RMB_PROFILE_ZONE("TalonFXPositionController::getVelocity");
+  // Signals in a registry are refreshed in a batch by its owner.
+  if (!signalRegistry) {
+    velocitySignal->Refresh();
   }
+  return velocitySignal->GetValue();
 }
 
 units::radian_t TalonFXPositionController::getPosition() const {
-  if (usingCANCoder) {
-    return canCoder->GetPosition().GetValue();
-  } else {
-    return motorcontroller.GetPosition().GetValue();
+  RMB_PROFILE_ZONE("TalonFXPositionController::getPosition");
+  if (!signalRegistry) {
+    positionSignal->Refresh();
   }
+  return positionSignal->GetValue();
+}
+
+units::second_t TalonFXPositionController::getPositionTimestamp() const {
+  return positionSignal->GetTimestamp().GetTime();
+}
+
+units::second_t TalonFXPositionController::getVelocityTimestamp() const {
+  return velocitySignal->GetTimestamp().GetTime();
 }
 
 void TalonFXPositionController::setEncoderPosition(units::radian_t position) {
@@ -165,7 +201,9 @@ void TalonFXPositionController::setEncoderPosition(units::radian_t position) {
 }
 
 void TalonFXPositionController::setPower(double power) {
+  RMB_PROFILE_ZONE("TalonFXPositionController::setPower");
   motorcontroller.Set(power);
+  setpointLog.record({0.0, power});
 }
 
 double TalonFXPositionController::getPower() const {
@@ -4,6 +4,8 @@
 #include <ctre/phoenix6/TalonFX.hpp>
 
 #include "rmb/motorcontrol/AngularPositionController.h"
+#include "rmb/motorcontrol/Talon/StatusSignalRegistry.h"
+#include "rmb/util/DataLogRecorder.h"
 
 #include "units/angle.h"
 #include "units/angular_acceleration.h"
@@ -12,6 +14,7 @@
 #include "units/current.h"
 #include "units/time.h"
 
+#include <memory>
 #include <optional>
 
 namespace rmb {
@@ -151,6 +154,10 @@ public:
     TalonFXPositionControllerHelper::CurrentLimits currentLimits;
     std::optional<TalonFXPositionControllerHelper::CANCoderConfig>
         canCoderConfig;
+    /** If set, position and velocity are only refreshed by the registry. */
+    std::shared_ptr<StatusSignalRegistry> signalRegistry = nullptr;
+    /** If set, every setpoint sent to the motor is recorded. */
+    std::shared_ptr<DataLogRecorder> recorder = nullptr;
   };
 
   /**
@@ -160,7 +167,7 @@ public:
    */
   TalonFXPositionController(const CreateInfo &createInfo);
 
-  virtual ~TalonFXPositionController() = default;
+  virtual ~TalonFXPositionController();
 
   /**
    * Sets a closed loop position setpoint on the TalonFX to the given position
@@ -220,6 +227,18 @@ public:
    */
   units::radian_t getPosition() const override;
 
+  /**
+   * Get the time the position returned by `getPosition()` was measured.
+   * @return The measurement time in seconds on the Phoenix timebase
+   */
+  units::second_t getPositionTimestamp() const;
+
+  /**
+   * Get the time the velocity returned by `getVelocity()` was measured.
+   * @return The measurement time in seconds on the Phoenix timebase
+   */
+  units::second_t getVelocityTimestamp() const;
+
   /**
    * Sets the encoder's reported position
    * @param position The position to reset the reference to. Defaults to 0
@@ -251,5 +270,17 @@ private:
   float sensorToMechanismRatio = 0.0;
 
   const bool usingCANCoder;
+
+  /** Position signal of the feedback device (TalonFX or CANcoder). */
+  ctre::phoenix6::StatusSignal<units::turn_t> *positionSignal = nullptr;
+
+  /** Velocity signal of the feedback device (TalonFX or CANcoder). */
+  ctre::phoenix6::StatusSignal<units::turns_per_second_t> *velocitySignal =
+      nullptr;
+
+  std::shared_ptr<StatusSignalRegistry> signalRegistry;
+
+  /** Control mode (0 for power, 1 for closed loop) and setpoint sent. */
+  DataLogChannel setpointLog;
 };
 } // namespace rmb
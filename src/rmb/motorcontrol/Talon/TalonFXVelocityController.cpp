@@ -1,15 +1,22 @@
 #include "TalonFXVelocityController.h"
 #include "ctre/phoenix6/controls/DutyCycleOut.hpp"
+#include "rmb/util/Profiler.h"
 #include "units/angular_velocity.h"
 
 #include <iostream>
+#include <string>
 
 namespace rmb {
 
 TalonFXVelocityController::TalonFXVelocityController(
     const TalonFXVelocityController::CreateInfo &createInfo)
     : motorcontroller(createInfo.config.id, "rio"),
-      usingCANCoder(createInfo.canCoderConfig.has_value()) {
+      usingCANCoder(createInfo.canCoderConfig.has_value()),
+      signalRegistry(createInfo.signalRegistry),
+      setpointLog(createInfo.recorder,
+                  "talonfx/" + std::to_string(createInfo.config.id) +
+                      "/setpoint",
+                  "mode (0 power, 1 velocity), setpoint (power or rad/s)") {
   auto &configurator = motorcontroller.GetConfigurator();
 
   ctre::phoenix6::configs::TalonFXConfiguration talonFXConfig{};
@@ -109,10 +116,29 @@ TalonFXVelocityController::TalonFXVelocityController(
   configurator.Apply(talonFXConfig);
 
   this->profileConfig = createInfo.profileConfig;
+
+  if (usingCANCoder) {
+    positionSignal = &canCoder->GetPosition();
+    velocitySignal = &canCoder->GetVelocity();
+  } else {
+    positionSignal = &motorcontroller.GetPosition();
+    velocitySignal = &motorcontroller.GetVelocity();
+  }
+
+  if (signalRegistry) {
+    signalRegistry->addSignals({positionSignal, velocitySignal});
+  }
+}
+
+TalonFXVelocityController::~TalonFXVelocityController() {
+  if (signalRegistry) {
+    signalRegistry->removeSignals({positionSignal, velocitySignal});
+  }
 }
 
 void TalonFXVelocityController::setVelocity(
     units::radians_per_second_t velocity) {
+  RMB_PROFILE_ZONE("TalonFXVelocityController::setVelocity");
   units::radians_per_second_t targetVelocity(velocity);
 
   if (velocity > profileConfig.maxVelocity) {
@@ -121,9 +147,9 @@ void TalonFXVelocityController::setVelocity(
     targetVelocity = profileConfig.minVelocity;
   }
 
-  // units::millisecond_t start = frc::Timer::GetFPGATimestamp();
   motorcontroller.SetControl(
       ctre::phoenix6::controls::VelocityDutyCycle(velocity));
+  setpointLog.record({1.0, velocity()});
 }
 
 units::radians_per_second_t
@@ -133,15 +159,18 @@ TalonFXVelocityController::getTargetVelocity() const {
 }
 
 units::radians_per_second_t TalonFXVelocityController::getVelocity() const {
-  if (usingCANCoder) {
-    return canCoder->GetVelocity().GetValue();
-  } else {
-    return motorcontroller.GetVelocity().GetValue();
+  RMB_PROFILE_ZONE("TalonFXVelocityController::getVelocity");
+  // Signals in a registry are refreshed in a batch by its owner.
+  if (!signalRegistry) {
+    velocitySignal->Refresh();
   }
+  return velocitySignal->GetValue();
 }
 
 void TalonFXVelocityController::setPower(double power) {
+  RMB_PROFILE_ZONE("TalonFXVelocityController::setPower");
   motorcontroller.SetControl(ctre::phoenix6::controls::DutyCycleOut(power));
+  setpointLog.record({0.0, power});
   // motorcontroller.Set(power);
 
   // std::cout << "power: " << power;
@@ -157,11 +186,19 @@ void TalonFXVelocityController::disable() { motorcontroller.Disable(); }
 void TalonFXVelocityController::stop() { motorcontroller.StopMotor(); }
 
 units::radian_t TalonFXVelocityController::getPosition() const {
-  if (usingCANCoder) {
-    return canCoder->GetPosition().GetValue();
-  } else {
-    return motorcontroller.GetPosition().GetValue();
+  RMB_PROFILE_ZONE("TalonFXVelocityController::getPosition");
+  if (!signalRegistry) {
+    positionSignal->Refresh();
   }
+  return positionSignal->GetValue();
+}
+
+units::second_t TalonFXVelocityController::getPositionTimestamp() const {
+  return positionSignal->GetTimestamp().GetTime();
+}
+
+units::second_t TalonFXVelocityController::getVelocityTimestamp() const {
+  return velocitySignal->GetTimestamp().GetTime();
 }
 
 void TalonFXVelocityController::setEncoderPosition(units::radian_t position) {
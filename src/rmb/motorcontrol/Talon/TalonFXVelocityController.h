@@ -1,8 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 
 #include "rmb/motorcontrol/AngularVelocityController.h"
+#include "rmb/motorcontrol/Talon/StatusSignalRegistry.h"
+#include "rmb/util/DataLogRecorder.h"
 
 #include "TalonFXPositionController.h"
 #include "units/angular_velocity.h"
@@ -41,11 +44,15 @@ public:
     TalonFXPositionControllerHelper::CurrentLimits currentLimits;
     std::optional<TalonFXPositionControllerHelper::CANCoderConfig>
         canCoderConfig;
+    /** If set, position and velocity are only refreshed by the registry. */
+    std::shared_ptr<StatusSignalRegistry> signalRegistry = nullptr;
+    /** If set, every setpoint sent to the motor is recorded. */
+    std::shared_ptr<DataLogRecorder> recorder = nullptr;
   };
 
   TalonFXVelocityController(const CreateInfo &createInfo);
 
-  virtual ~TalonFXVelocityController() = default;
+  virtual ~TalonFXVelocityController();
 
   //--------------------------------------------------
   // Methods Inherited from AngularVelocityController
@@ -103,6 +110,18 @@ public:
    */
   units::radian_t getPosition() const override;
 
+  /**
+   * Get the time the position returned by `getPosition()` was measured.
+   * @return The measurement time in seconds on the Phoenix timebase
+   */
+  units::second_t getPositionTimestamp() const;
+
+  /**
+   * Get the time the velocity returned by `getVelocity()` was measured.
+   * @return The measurement time in seconds on the Phoenix timebase
+   */
+  units::second_t getVelocityTimestamp() const;
+
   /**
    * Sets the encoder's reported position
    * @param position The position to reset the reference to. Defaults to 0
@@ -138,6 +157,18 @@ private:
   const bool usingCANCoder;
 
   mutable std::optional<ctre::phoenix6::hardware::CANcoder> canCoder;
+
+  /** Position signal of the feedback device (TalonFX or CANcoder). */
+  ctre::phoenix6::StatusSignal<units::turn_t> *positionSignal = nullptr;
+
+  /** Velocity signal of the feedback device (TalonFX or CANcoder). */
+  ctre::phoenix6::StatusSignal<units::turns_per_second_t> *velocitySignal =
+      nullptr;
+
+  std::shared_ptr<StatusSignalRegistry> signalRegistry;
+
+  /** Control mode (0 for power, 1 for closed loop) and setpoint sent. */
+  DataLogChannel setpointLog;
 };
 
 } // namespace rmb
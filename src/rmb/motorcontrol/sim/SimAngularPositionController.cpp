@@ -0,0 +1,47 @@
+#include "rmb/motorcontrol/sim/SimAngularPositionController.h"
+
+#include <algorithm>
+
+namespace rmb {
+
+SimAngularPositionController::SimAngularPositionController(
+    const CreateInfo &createInfo)
+    : mechanism({createInfo.motorConfig, createInfo.pidConfig,
+                 createInfo.encoderConfig, createInfo.continuousWrap}),
+      minPosition(createInfo.minPosition), maxPosition(createInfo.maxPosition),
+      tolerance(createInfo.tolerance) {}
+
+void SimAngularPositionController::setPosition(units::radian_t position) {
+  mechanism.setPosition(std::clamp(position, minPosition, maxPosition));
+}
+
+units::radian_t SimAngularPositionController::getTargetPosition() const {
+  return mechanism.getTargetPosition();
+}
+
+void SimAngularPositionController::setPower(double power) {
+  mechanism.setPower(power);
+}
+
+double SimAngularPositionController::getPower() const {
+  return mechanism.getPower();
+}
+
+void SimAngularPositionController::disable() { mechanism.setNeutral(); }
+
+void SimAngularPositionController::stop() { mechanism.setNeutral(); }
+
+units::radians_per_second_t SimAngularPositionController::getVelocity() const {
+  return mechanism.getVelocity();
+}
+
+units::radian_t SimAngularPositionController::getPosition() const {
+  return mechanism.getPosition();
+}
+
+void SimAngularPositionController::setEncoderPosition(
+    units::radian_t position) {
+  mechanism.setEncoderPosition(position);
+}
+
+} // namespace rmb
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <limits>
+
+#include "rmb/motorcontrol/AngularPositionController.h"
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+
+#include "units/angle.h"
+#include "units/angular_velocity.h"
+
+namespace rmb {
+
+/**
+ * Simulated angular position controller backed by a `SimMechanism`, for
+ * running mechanism and drive code without CAN hardware.
+ */
+class SimAngularPositionController : public AngularPositionController {
+public:
+  struct CreateInfo {
+    SimMechanismHelper::MotorConfig motorConfig;
+    SimMechanismHelper::PIDConfig pidConfig; /*< Volts per radian. */
+    SimMechanismHelper::EncoderConfig encoderConfig;
+    units::radian_t minPosition =
+        -std::numeric_limits<units::radian_t>::infinity();
+    units::radian_t maxPosition =
+        std::numeric_limits<units::radian_t>::infinity();
+    bool continuousWrap = false; /*< Take the shortest way around. */
+    units::radian_t tolerance = 0.0_rad;
+  };
+
+  /**
+   * Creates a simulated angular position controller.
+   * @param createInfo CreateInfo struct used to initialize the controller
+   */
+  SimAngularPositionController(const CreateInfo &createInfo);
+
+  void setPosition(units::radian_t position) override;
+
+  units::radian_t getTargetPosition() const override;
+
+  void setPower(double power) override;
+
+  double getPower() const override;
+
+  units::radian_t getMinPosition() const override { return minPosition; }
+
+  units::radian_t getMaxPosition() const override { return maxPosition; }
+
+  void disable() override;
+
+  void stop() override;
+
+  units::radians_per_second_t getVelocity() const override;
+
+  units::radian_t getPosition() const override;
+
+  void setEncoderPosition(units::radian_t position = 0_rad) override;
+
+  units::radian_t getTolerance() const override { return tolerance; }
+
+  /**
+   * Get the simulated mechanism, to step it or read its true state.
+   */
+  SimMechanism &getMechanism() { return mechanism; }
+
+private:
+  SimMechanism mechanism;
+
+  units::radian_t minPosition, maxPosition;
+  units::radian_t tolerance;
+};
+} // namespace rmb
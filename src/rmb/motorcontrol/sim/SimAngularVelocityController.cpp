@@ -0,0 +1,46 @@
+#include "rmb/motorcontrol/sim/SimAngularVelocityController.h"
+
+namespace rmb {
+
+SimAngularVelocityController::SimAngularVelocityController(
+    const CreateInfo &createInfo)
+    : mechanism({createInfo.motorConfig, createInfo.pidConfig,
+                 createInfo.encoderConfig}),
+      tolerance(createInfo.tolerance) {}
+
+void SimAngularVelocityController::setVelocity(
+    units::radians_per_second_t velocity) {
+  mechanism.setVelocity(velocity);
+}
+
+units::radians_per_second_t
+SimAngularVelocityController::getTargetVelocity() const {
+  return mechanism.getTargetVelocity();
+}
+
+void SimAngularVelocityController::setPower(double power) {
+  mechanism.setPower(power);
+}
+
+double SimAngularVelocityController::getPower() const {
+  return mechanism.getPower();
+}
+
+void SimAngularVelocityController::disable() { mechanism.setNeutral(); }
+
+void SimAngularVelocityController::stop() { mechanism.setNeutral(); }
+
+units::radians_per_second_t SimAngularVelocityController::getVelocity() const {
+  return mechanism.getVelocity();
+}
+
+units::radian_t SimAngularVelocityController::getPosition() const {
+  return mechanism.getPosition();
+}
+
+void SimAngularVelocityController::setEncoderPosition(
+    units::radian_t position) {
+  mechanism.setEncoderPosition(position);
+}
+
+} // namespace rmb
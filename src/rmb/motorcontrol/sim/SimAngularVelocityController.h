@@ -0,0 +1,62 @@
+#pragma once
+
+#include "rmb/motorcontrol/AngularVelocityController.h"
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+
+#include "units/angle.h"
+#include "units/angular_velocity.h"
+
+namespace rmb {
+
+/**
+ * Simulated angular velocity controller backed by a `SimMechanism`, for
+ * running mechanism and drive code without CAN hardware.
+ */
+class SimAngularVelocityController : public AngularVelocityController {
+public:
+  struct CreateInfo {
+    SimMechanismHelper::MotorConfig motorConfig;
+    SimMechanismHelper::PIDConfig pidConfig; /*< Volts per radian/second. */
+    SimMechanismHelper::EncoderConfig encoderConfig;
+    units::radians_per_second_t tolerance = 0.0_rad_per_s;
+  };
+
+  /**
+   * Creates a simulated angular velocity controller.
+   * @param createInfo CreateInfo struct used to initialize the controller
+   */
+  SimAngularVelocityController(const CreateInfo &createInfo);
+
+  void setVelocity(units::radians_per_second_t velocity) override;
+
+  units::radians_per_second_t getTargetVelocity() const override;
+
+  void setPower(double power) override;
+
+  double getPower() const override;
+
+  void disable() override;
+
+  void stop() override;
+
+  units::radians_per_second_t getVelocity() const override;
+
+  units::radian_t getPosition() const override;
+
+  void setEncoderPosition(units::radian_t position = 0_rad) override;
+
+  units::radians_per_second_t getTolerance() const override {
+    return tolerance;
+  }
+
+  /**
+   * Get the simulated mechanism, to step it or read its true state.
+   */
+  SimMechanism &getMechanism() { return mechanism; }
+
+private:
+  SimMechanism mechanism;
+
+  units::radians_per_second_t tolerance;
+};
+} // namespace rmb
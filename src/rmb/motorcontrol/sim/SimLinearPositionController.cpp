@@ -0,0 +1,49 @@
+#include "rmb/motorcontrol/sim/SimLinearPositionController.h"
+
+#include <algorithm>
+
+namespace rmb {
+
+SimLinearPositionController::SimLinearPositionController(
+    const CreateInfo &createInfo)
+    : conversion(createInfo.conversion),
+      mechanism({createInfo.motorConfig,
+                 createInfo.pidConfig.scaled(createInfo.conversion.value()),
+                 createInfo.encoderConfig}),
+      minPosition(createInfo.minPosition), maxPosition(createInfo.maxPosition),
+      tolerance(createInfo.tolerance) {}
+
+void SimLinearPositionController::setPosition(units::meter_t position) {
+  mechanism.setPosition(std::clamp(position, minPosition, maxPosition) /
+                        conversion);
+}
+
+units::meter_t SimLinearPositionController::getTargetPosition() const {
+  return mechanism.getTargetPosition() * conversion;
+}
+
+void SimLinearPositionController::setPower(double power) {
+  mechanism.setPower(power);
+}
+
+double SimLinearPositionController::getPower() const {
+  return mechanism.getPower();
+}
+
+void SimLinearPositionController::disable() { mechanism.setNeutral(); }
+
+void SimLinearPositionController::stop() { mechanism.setNeutral(); }
+
+units::meters_per_second_t SimLinearPositionController::getVelocity() const {
+  return mechanism.getVelocity() * conversion;
+}
+
+units::meter_t SimLinearPositionController::getPosition() const {
+  return mechanism.getPosition() * conversion;
+}
+
+void SimLinearPositionController::setEncoderPosition(units::meter_t position) {
+  mechanism.setEncoderPosition(position / conversion);
+}
+
+} // namespace rmb
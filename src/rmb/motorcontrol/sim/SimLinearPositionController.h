@@ -0,0 +1,78 @@
+#pragma once
+
+#include <limits>
+
+#include "rmb/motorcontrol/AngularPositionController.h"
+#include "rmb/motorcontrol/LinearPositionController.h"
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+
+#include "units/length.h"
+#include "units/velocity.h"
+
+namespace rmb {
+
+/**
+ * Simulated linear position controller, such as an elevator, backed by a
+ * `SimMechanism`.
+ */
+class SimLinearPositionController : public LinearPositionController {
+public:
+  struct CreateInfo {
+    SimMechanismHelper::MotorConfig motorConfig;
+    SimMechanismHelper::PIDConfig pidConfig; /*< Volts per meter. */
+    SimMechanismHelper::EncoderConfig encoderConfig;
+    AngularPositionController::ConversionUnit_t
+        conversion; /*< Distance per radian of the mechanism, such as a drum
+                        radius per radian. */
+    units::meter_t minPosition =
+        -std::numeric_limits<units::meter_t>::infinity();
+    units::meter_t maxPosition =
+        std::numeric_limits<units::meter_t>::infinity();
+    units::meter_t tolerance = 0.0_m;
+  };
+
+  /**
+   * Creates a simulated linear position controller.
+   * @param createInfo CreateInfo struct used to initialize the controller
+   */
+  SimLinearPositionController(const CreateInfo &createInfo);
+
+  void setPosition(units::meter_t position) override;
+
+  units::meter_t getTargetPosition() const override;
+
+  void setPower(double power) override;
+
+  double getPower() const override;
+
+  units::meter_t getMinPosition() const override { return minPosition; }
+
+  units::meter_t getMaxPosition() const override { return maxPosition; }
+
+  void disable() override;
+
+  void stop() override;
+
+  units::meters_per_second_t getVelocity() const override;
+
+  units::meter_t getPosition() const override;
+
+  void setEncoderPosition(units::meter_t position = 0_m) override;
+
+  units::meter_t getTolerance() const override { return tolerance; }
+
+  /**
+   * Get the simulated mechanism, to step it or read its true state in
+   * radians.
+   */
+  SimMechanism &getMechanism() { return mechanism; }
+
+private:
+  AngularPositionController::ConversionUnit_t conversion;
+
+  SimMechanism mechanism;
+
+  units::meter_t minPosition, maxPosition;
+  units::meter_t tolerance;
+};
+} // namespace rmb
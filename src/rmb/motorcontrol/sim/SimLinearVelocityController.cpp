@@ -0,0 +1,47 @@
+#include "rmb/motorcontrol/sim/SimLinearVelocityController.h"
+
+namespace rmb {
+
+SimLinearVelocityController::SimLinearVelocityController(
+    const CreateInfo &createInfo)
+    : conversion(createInfo.conversion),
+      mechanism({createInfo.motorConfig,
+                 createInfo.pidConfig.scaled(createInfo.conversion.value()),
+                 createInfo.encoderConfig}),
+      tolerance(createInfo.tolerance) {}
+
+void SimLinearVelocityController::setVelocity(
+    units::meters_per_second_t velocity) {
+  mechanism.setVelocity(velocity / conversion);
+}
+
+units::meters_per_second_t
+SimLinearVelocityController::getTargetVelocity() const {
+  return mechanism.getTargetVelocity() * conversion;
+}
+
+void SimLinearVelocityController::setPower(double power) {
+  mechanism.setPower(power);
+}
+
+double SimLinearVelocityController::getPower() const {
+  return mechanism.getPower();
+}
+
+void SimLinearVelocityController::disable() { mechanism.setNeutral(); }
+
+void SimLinearVelocityController::stop() { mechanism.setNeutral(); }
+
+units::meters_per_second_t SimLinearVelocityController::getVelocity() const {
+  return mechanism.getVelocity() * conversion;
+}
+
+units::meter_t SimLinearVelocityController::getPosition() const {
+  return mechanism.getPosition() * conversion;
+}
+
+void SimLinearVelocityController::setEncoderPosition(units::meter_t position) {
+  mechanism.setEncoderPosition(position / conversion);
+}
+
+} // namespace rmb
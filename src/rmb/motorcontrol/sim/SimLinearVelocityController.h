@@ -0,0 +1,69 @@
+#pragma once
+
+#include "rmb/motorcontrol/AngularVelocityController.h"
+#include "rmb/motorcontrol/LinearVelocityController.h"
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+
+#include "units/length.h"
+#include "units/velocity.h"
+
+namespace rmb {
+
+/**
+ * Simulated linear velocity controller, such as a drive wheel, backed by a
+ * `SimMechanism`.
+ */
+class SimLinearVelocityController : public LinearVelocityController {
+public:
+  struct CreateInfo {
+    SimMechanismHelper::MotorConfig motorConfig;
+    SimMechanismHelper::PIDConfig pidConfig; /*< Volts per meter/second. */
+    SimMechanismHelper::EncoderConfig encoderConfig;
+    AngularVelocityController::ConversionUnit_t
+        conversion; /*< Distance per radian of the mechanism, such as a wheel
+                        radius per radian. */
+    units::meters_per_second_t tolerance = 0.0_mps;
+  };
+
+  /**
+   * Creates a simulated linear velocity controller.
+   * @param createInfo CreateInfo struct used to initialize the controller
+   */
+  SimLinearVelocityController(const CreateInfo &createInfo);
+
+  void setVelocity(units::meters_per_second_t velocity) override;
+
+  units::meters_per_second_t getTargetVelocity() const override;
+
+  void setPower(double power) override;
+
+  double getPower() const override;
+
+  void disable() override;
+
+  void stop() override;
+
+  units::meters_per_second_t getVelocity() const override;
+
+  units::meter_t getPosition() const override;
+
+  void setEncoderPosition(units::meter_t position = 0_m) override;
+
+  units::meters_per_second_t getTolerance() const override {
+    return tolerance;
+  }
+
+  /**
+   * Get the simulated mechanism, to step it or read its true state in
+   * radians.
+   */
+  SimMechanism &getMechanism() { return mechanism; }
+
+private:
+  AngularVelocityController::ConversionUnit_t conversion;
+
+  SimMechanism mechanism;
+
+  units::meters_per_second_t tolerance;
+};
+} // namespace rmb
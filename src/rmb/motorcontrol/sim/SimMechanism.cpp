@@ -0,0 +1,188 @@
+#include "rmb/motorcontrol/sim/SimMechanism.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <frc/MathUtil.h>
+
+namespace rmb {
+
+namespace {
+
+// Each thread steps the mechanisms it created, so simulations on separate
+// threads never touch each other.
+thread_local std::vector<SimMechanism *> mechanisms;
+
+} // namespace
+
+SimMechanism::SimMechanism(const CreateInfo &createInfo)
+    : motorConfig(createInfo.motorConfig), pidConfig(createInfo.pidConfig),
+      continuousPosition(createInfo.continuousPosition),
+      resistance(createInfo.motorConfig.motor.R.value()),
+      kv(createInfo.motorConfig.motor.Kv.value()),
+      kt(createInfo.motorConfig.motor.Kt.value()),
+      gearing(createInfo.motorConfig.gearing),
+      moi(createInfo.motorConfig.moi.value()),
+      busVoltage(createInfo.motorConfig.busVoltage.value()),
+      currentLimit(createInfo.motorConfig.currentLimit.value()),
+      countsPerRadian(createInfo.encoderConfig.countsPerRevolution *
+                      createInfo.motorConfig.gearing /
+                      (2.0 * std::numbers::pi)) {
+  size_t latencySteps = static_cast<size_t>(
+      std::max(std::round(createInfo.encoderConfig.latency / kControlPeriod),
+               0.0));
+  measurements.resize(latencySteps + 1);
+
+  mechanisms.push_back(this);
+}
+
+SimMechanism::~SimMechanism() {
+  auto mechanism = std::find(mechanisms.begin(), mechanisms.end(), this);
+  if (mechanism != mechanisms.end()) {
+    mechanisms.erase(mechanism);
+  }
+}
+
+void SimMechanism::updateAll(units::second_t dt) {
+  for (SimMechanism *mechanism : mechanisms) {
+    mechanism->update(dt);
+  }
+}
+
+void SimMechanism::update(units::second_t dt) {
+  pendingTime += dt;
+
+  // Compare against slightly less than a period so sums of periods that
+  // round just below a whole number of steps do not lose one.
+  while (pendingTime >= kControlPeriod * (1.0 - 1e-9)) {
+    step();
+    pendingTime -= kControlPeriod;
+  }
+}
+
+void SimMechanism::setPower(double newPower) {
+  mode = ControlMode::Power;
+  power = std::clamp(newPower, -1.0, 1.0);
+}
+
+void SimMechanism::setPosition(units::radian_t target) {
+  if (mode != ControlMode::Position) {
+    integral = 0.0;
+    lastError = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  mode = ControlMode::Position;
+  targetPosition = target;
+}
+
+void SimMechanism::setVelocity(units::radians_per_second_t target) {
+  if (mode != ControlMode::Velocity) {
+    integral = 0.0;
+    lastError = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  mode = ControlMode::Velocity;
+  targetVelocity = target;
+}
+
+void SimMechanism::setNeutral() { mode = ControlMode::Neutral; }
+
+double SimMechanism::getPower() const { return voltage / busVoltage; }
+
+units::radian_t SimMechanism::getPosition() const {
+  return units::radian_t(measurements[nextMeasurement].position +
+                         encoderOffset);
+}
+
+units::radians_per_second_t SimMechanism::getVelocity() const {
+  return units::radians_per_second_t(measurements[nextMeasurement].velocity);
+}
+
+void SimMechanism::setEncoderPosition(units::radian_t newPosition) {
+  encoderOffset = newPosition.value() - measure().position;
+}
+
+SimMechanism::Measurement SimMechanism::measure() const {
+  Measurement measurement{position, velocity};
+  if (countsPerRadian > 0.0) {
+    measurement.position =
+        std::floor(position * countsPerRadian) / countsPerRadian;
+  }
+
+  return measurement;
+}
+
+double SimMechanism::getControlVoltage(const Measurement &measurement) {
+  double error = 0.0, feedforward = 0.0;
+  switch (mode) {
+  case ControlMode::Neutral:
+    return 0.0;
+  case ControlMode::Power:
+    return power * busVoltage;
+  case ControlMode::Position:
+    error = targetPosition.value() - (measurement.position + encoderOffset);
+    if (continuousPosition) {
+      error = frc::AngleModulus(units::radian_t(error)).value();
+    }
+    break;
+  case ControlMode::Velocity:
+    error = targetVelocity.value() - measurement.velocity;
+    feedforward = pidConfig.ff * targetVelocity.value();
+    break;
+  }
+
+  double dt = kControlPeriod.value();
+  double derivative = std::isnan(lastError) ? 0.0 : (error - lastError) / dt;
+  integral += error * dt;
+  lastError = error;
+
+  return std::clamp(pidConfig.p * error + pidConfig.i * integral +
+                        pidConfig.d * derivative + feedforward,
+                    -busVoltage, busVoltage);
+}
+
+void SimMechanism::step() {
+  // The onboard controller sees the encoder without the reporting latency.
+  double applied = getControlVoltage(measure());
+  double h = kControlPeriod.value();
+
+  double motorVelocity = velocity * gearing;
+  double backEmf = motorVelocity / kv;
+
+  if (mode == ControlMode::Neutral && !motorConfig.brake) {
+    // Coasting, so no current flows.
+    double acceleration = loadTorque / moi;
+    voltage = 0.0;
+    current = 0.0;
+    position += velocity * h + 0.5 * acceleration * h * h;
+    velocity += acceleration * h;
+  } else {
+    // A stator current limit lowers the effective voltage so the current
+    // at the start of the step is within the limit.
+    if (currentLimit > 0.0) {
+      double limit = currentLimit * resistance;
+      applied = std::clamp(applied, backEmf - limit, backEmf + limit);
+      applied = std::clamp(applied, -busVoltage, busVoltage);
+    }
+
+    // dw/dt = a - b * w, integrated exactly over the step.
+    double a = (kt * gearing * applied / resistance + loadTorque) / moi;
+    double b = kt * gearing * gearing / (kv * resistance * moi);
+    double steadyVelocity = a / b;
+    double decay = std::exp(-b * h);
+
+    position +=
+        steadyVelocity * h + (velocity - steadyVelocity) * (1.0 - decay) / b;
+    velocity = steadyVelocity + (velocity - steadyVelocity) * decay;
+
+    voltage = applied;
+    current = (applied - velocity * gearing / kv) / resistance;
+  }
+
+  measurements[nextMeasurement] = measure();
+  nextMeasurement = (nextMeasurement + 1) % measurements.size();
+  steps++;
+}
+
+} // namespace rmb
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <frc/system/plant/DCMotor.h>
+
+#include "units/angle.h"
+#include "units/angular_velocity.h"
+#include "units/current.h"
+#include "units/moment_of_inertia.h"
+#include "units/torque.h"
+#include "units/time.h"
+#include "units/voltage.h"
+
+namespace rmb {
+namespace SimMechanismHelper {
+struct MotorConfig {
+  /** Motors driving the mechanism, such as `frc::DCMotor::Falcon500(2)`. */
+  frc::DCMotor motor = frc::DCMotor::Falcon500();
+  double gearing = 1.0; /*< Motor rotations per mechanism rotation. */
+  units::kilogram_square_meter_t moi =
+      0.001_kg_sq_m; /*< Moment of inertia seen by the mechanism shaft. For a
+                         mass m moved by a drum or wheel of radius r this is
+                         m * r^2. */
+  units::ampere_t currentLimit = 0.0_A; /*< Stator limit. 0_A disables. */
+  units::volt_t busVoltage = 12.0_V;    /*< Voltage at full power. */
+  bool brake = false; /*< Short the motor rather than coast when neutral. */
+};
+
+struct EncoderConfig {
+  units::second_t latency =
+      0.0_s; /*< Age of reported measurements, rounded to whole control
+                 periods. */
+  int countsPerRevolution = 0; /*< Per motor rotation. 0 disables
+                                   quantization. */
+};
+
+/**
+ * Gains of the simulated controller's onboard loop in volts, run every
+ * `SimMechanism::kControlPeriod`.
+ */
+struct PIDConfig {
+  double p = 0.0, i = 0.0, d = 0.0,
+         ff = 0.0; /*< ff is volts per unit of target velocity. */
+
+  /**
+   * Returns the gains multiplied by `factor`, such as meters per radian to
+   * turn gains on meters into gains on radians.
+   */
+  PIDConfig scaled(double factor) const {
+    return {p * factor, i * factor, d * factor, ff * factor};
+  }
+};
+} // namespace SimMechanismHelper
+
+/**
+ * Physics model of a mechanism driven through a gearbox by DC motors, with
+ * the closed loop control and encoder of a smart motor controller.
+ *
+ * The motor is modeled without inductance, so within each control period the
+ * speed approaches the free speed of the applied voltage exponentially. That
+ * step is integrated exactly, so it stays stable for any inertia and gives
+ * the same result for the same sequence of updates on every machine.
+ *
+ * Mechanisms do not advance on their own. Call `update()` on one, or
+ * `updateAll()` to step every mechanism created on the calling thread. Create
+ * and destroy a mechanism on the thread that drives it, so independent
+ * simulations can run on separate threads at once.
+ */
+class SimMechanism {
+public:
+  /** Period of the onboard control loop and of every physics step. */
+  static constexpr units::second_t kControlPeriod = 1.0_ms;
+
+  enum class ControlMode { Neutral, Power, Position, Velocity };
+
+  struct CreateInfo {
+    SimMechanismHelper::MotorConfig motorConfig;
+    SimMechanismHelper::PIDConfig pidConfig;
+    SimMechanismHelper::EncoderConfig encoderConfig;
+    bool continuousPosition =
+        false; /*< Wrap position error to [-pi, pi), as for a swerve module
+                   azimuth. */
+  };
+
+  SimMechanism(const SimMechanism &) = delete;
+  SimMechanism(SimMechanism &&) = delete;
+
+  explicit SimMechanism(const CreateInfo &createInfo);
+
+  ~SimMechanism();
+
+  /**
+   * Advances the simulation by `dt` in steps of `kControlPeriod`. Time left
+   * over is carried into the next update.
+   */
+  void update(units::second_t dt);
+
+  /**
+   * Advances every mechanism created on this thread by `dt`, in the order
+   * they were created.
+   */
+  static void updateAll(units::second_t dt);
+
+  void setPower(double power);
+
+  void setPosition(units::radian_t target);
+
+  void setVelocity(units::radians_per_second_t target);
+
+  /**
+   * Stops driving the motor. It brakes or coasts as configured.
+   */
+  void setNeutral();
+
+  ControlMode getControlMode() const { return mode; }
+
+  units::radian_t getTargetPosition() const { return targetPosition; }
+
+  units::radians_per_second_t getTargetVelocity() const {
+    return targetVelocity;
+  }
+
+  /**
+   * Returns the applied voltage as a fraction of the bus voltage.
+   */
+  double getPower() const;
+
+  /**
+   * Returns the position reported by the encoder, after its latency and
+   * quantization.
+   */
+  units::radian_t getPosition() const;
+
+  /**
+   * Returns the velocity reported by the encoder, after its latency.
+   */
+  units::radians_per_second_t getVelocity() const;
+
+  /**
+   * Offsets the encoder so it reports `newPosition` now.
+   */
+  void setEncoderPosition(units::radian_t newPosition);
+
+  /**
+   * Applies an external torque to the mechanism shaft, such as from the
+   * floor on a drive wheel, until changed.
+   */
+  void setLoadTorque(units::newton_meter_t torque) {
+    loadTorque = torque.value();
+  }
+
+  /**
+   * Exact position of the mechanism in the encoder's frame, without latency
+   * or quantization.
+   */
+  units::radian_t getTruePosition() const {
+    return units::radian_t(position + encoderOffset);
+  }
+
+  /** Exact velocity of the mechanism, without encoder effects. */
+  units::radians_per_second_t getTrueVelocity() const {
+    return units::radians_per_second_t(velocity);
+  }
+
+  /** Stator current drawn by all motors during the last step. */
+  units::ampere_t getCurrent() const { return units::ampere_t(current); }
+
+  units::volt_t getAppliedVoltage() const { return units::volt_t(voltage); }
+
+  units::kilogram_square_meter_t getMoi() const {
+    return units::kilogram_square_meter_t(moi);
+  }
+
+  /** Simulated time elapsed in whole control periods. */
+  units::second_t getTime() const { return kControlPeriod * steps; }
+
+private:
+  struct Measurement {
+    double position = 0.0; /* <- Radians, quantized, before the offset. */
+    double velocity = 0.0;
+  };
+
+  /**
+   * Runs the onboard controller and integrates one control period.
+   */
+  void step();
+
+  /**
+   * Returns the voltage requested by the control mode.
+   */
+  double getControlVoltage(const Measurement &measurement);
+
+  Measurement measure() const;
+
+  SimMechanismHelper::MotorConfig motorConfig;
+  SimMechanismHelper::PIDConfig pidConfig;
+  bool continuousPosition;
+
+  // Motor constants in SI units.
+  double resistance, kv, kt, gearing, moi, busVoltage, currentLimit;
+  double countsPerRadian;
+
+  ControlMode mode = ControlMode::Neutral;
+  double power = 0.0;
+  units::radian_t targetPosition = 0.0_rad;
+  units::radians_per_second_t targetVelocity = 0.0_rad_per_s;
+  double integral = 0.0;
+  double lastError = std::numeric_limits<double>::quiet_NaN();
+
+  // State of the mechanism in radians and radians per second.
+  double position = 0.0;
+  double velocity = 0.0;
+  double voltage = 0.0;
+  double current = 0.0;
+  double loadTorque = 0.0;
+  double encoderOffset = 0.0;
+
+  /** Ring of the measurements reported over the encoder latency. */
+  std::vector<Measurement> measurements;
+  size_t nextMeasurement = 0;
+
+  size_t steps = 0;
+  units::second_t pendingTime = 0.0_s;
+};
+} // namespace rmb
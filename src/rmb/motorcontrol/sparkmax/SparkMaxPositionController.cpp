@@ -1,6 +1,8 @@
 #include "rmb/motorcontrol/sparkmax/SparkMaxPositionController.h"
+#include "rmb/util/Profiler.h"
 
 #include <algorithm>
+#include <string>
 
 namespace rmb {
 SparkMaxPositionController::SparkMaxPositionController(
@@ -12,7 +14,11 @@ SparkMaxPositionController::SparkMaxPositionController(
       minPose(createInfo.range.minPosition),
       maxPose(createInfo.range.maxPosition),
       encoderType(createInfo.feedbackConfig.encoderType),
-      gearRatio(createInfo.feedbackConfig.gearRatio) {
+      gearRatio(createInfo.feedbackConfig.gearRatio),
+      setpointLog(createInfo.recorder,
+                  "sparkmax/" + std::to_string(createInfo.motorConfig.id) +
+                      "/setpoint",
+                  "mode (0 power, 1 position), setpoint (power or rad)") {
 
   // Restore defaults to ensure a consistent and clean slate.
   sparkMax.RestoreFactoryDefaults();
@@ -131,12 +137,14 @@ SparkMaxPositionController::SparkMaxPositionController(
 }
 
 void SparkMaxPositionController::setPosition(units::radian_t position) {
+  RMB_PROFILE_ZONE("SparkMaxPositionController::setPosition");
   targetPosition = pidController.GetPositionPIDWrappingEnabled()
                        ? position
                        : std::clamp(position, minPose, maxPose);
   pidController.SetReference(
       units::turn_t(targetPosition).to<double>() * gearRatio, controlType, 0,
       feedforward->calculateStatic(0.0_rpm, position).to<double>());
+  setpointLog.record({1.0, targetPosition()});
 }
 
 units::radian_t SparkMaxPositionController::getTargetPosition() const {
@@ -144,8 +152,10 @@ units::radian_t SparkMaxPositionController::getTargetPosition() const {
 }
 
 void SparkMaxPositionController::setPower(double power) {
+  RMB_PROFILE_ZONE("SparkMaxPositionController::setPower");
   targetPosition = 0.0_rad;
   sparkMax.Set(power);
+  setpointLog.record({0.0, power});
 }
 
 double SparkMaxPositionController::getPower() const { return sparkMax.Get(); }
@@ -163,7 +173,7 @@ void SparkMaxPositionController::disable() { sparkMax.Disable(); }
 void SparkMaxPositionController::stop() { sparkMax.StopMotor(); }
 
 units::radians_per_second_t SparkMaxPositionController::getVelocity() const {
-
+  RMB_PROFILE_ZONE("SparkMaxPositionController::getVelocity");
   switch (encoderType) {
   case EncoderType::HallSensor:
   case EncoderType::Quadrature: {
@@ -186,7 +196,7 @@ units::radians_per_second_t SparkMaxPositionController::getVelocity() const {
 }
 
 units::radian_t SparkMaxPositionController::getPosition() const {
-
+  RMB_PROFILE_ZONE("SparkMaxPositionController::getPosition");
   switch (encoderType) {
   case EncoderType::HallSensor:
   case EncoderType::Quadrature: {
@@ -11,6 +11,7 @@
 
 #include "rmb/motorcontrol/AngularPositionController.h"
 #include "rmb/motorcontrol/feedforward/SimpleFeedforward.h"
+#include "rmb/util/DataLogRecorder.h"
 
 namespace rmb {
 
@@ -82,6 +83,8 @@ public:
     const ProfileConfig profileConfig = {};
     const FeedbackConfig feedbackConfig = {};
     std::initializer_list<const MotorConfig> followers;
+    /** If set, every setpoint sent to the motor is recorded. */
+    const std::shared_ptr<DataLogRecorder> recorder = nullptr;
   };
 
   SparkMaxPositionController(SparkMaxPositionController &&) = delete;
@@ -194,5 +197,8 @@ private:
   std::unique_ptr<rev::MotorFeedbackSensor> encoder;
   EncoderType encoderType;
   double gearRatio;
+
+  /** Control mode (0 for power, 1 for closed loop) and setpoint sent. */
+  DataLogChannel setpointLog;
 };
 } // namespace rmb
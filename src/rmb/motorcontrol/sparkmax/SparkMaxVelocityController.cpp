@@ -1,4 +1,7 @@
 #include "rmb/motorcontrol/sparkmax/SparkMaxVelocityController.h"
+#include "rmb/util/Profiler.h"
+
+#include <string>
 
 #include <units/angle.h>
 #include <units/length.h>
@@ -11,7 +14,11 @@ SparkMaxVelocityController::SparkMaxVelocityController(
       pidController(sparkMax.GetPIDController()),
       tolerance(createInfo.pidConfig.tolerance),
       encoderType(createInfo.feedbackConfig.encoderType),
-      gearRatio(createInfo.feedbackConfig.gearRatio) {
+      gearRatio(createInfo.feedbackConfig.gearRatio),
+      setpointLog(createInfo.recorder,
+                  "sparkmax/" + std::to_string(createInfo.motorConfig.id) +
+                      "/setpoint",
+                  "mode (0 power, 1 velocity), setpoint (power or rad/s)") {
 
   // Restore defaults to ensure a consistent and clean slate.
   sparkMax.RestoreFactoryDefaults();
@@ -122,10 +129,12 @@ SparkMaxVelocityController::SparkMaxVelocityController(
 
 void SparkMaxVelocityController::setVelocity(
     units::radians_per_second_t velocity) {
+  RMB_PROFILE_ZONE("SparkMaxVelocityController::setVelocity");
   targetVelocity = velocity;
   pidController.SetReference(
       units::revolutions_per_minute_t(targetVelocity).to<double>() * gearRatio,
       controlType);
+  setpointLog.record({1.0, targetVelocity()});
 }
 
 units::radians_per_second_t
@@ -134,8 +143,10 @@ SparkMaxVelocityController::getTargetVelocity() const {
 }
 
 void SparkMaxVelocityController::setPower(double power) {
+  RMB_PROFILE_ZONE("SparkMaxVelocityController::setPower");
   targetVelocity = 0.0_rad_per_s;
   sparkMax.Set(power);
+  setpointLog.record({0.0, power});
 }
 
 double SparkMaxVelocityController::getPower() const { return sparkMax.Get(); }
@@ -151,6 +162,7 @@ void SparkMaxVelocityController::stop() {
 }
 
 units::radians_per_second_t SparkMaxVelocityController::getVelocity() const {
+  RMB_PROFILE_ZONE("SparkMaxVelocityController::getVelocity");
   using EncoderType = SparkMaxVelocityControllerHelper::EncoderType;
 
   switch (encoderType) {
@@ -176,6 +188,7 @@ units::radians_per_second_t SparkMaxVelocityController::getVelocity() const {
 }
 
 units::radian_t SparkMaxVelocityController::getPosition() const {
+  RMB_PROFILE_ZONE("SparkMaxVelocityController::getPosition");
   using EncoderType = SparkMaxVelocityControllerHelper::EncoderType;
 
   switch (encoderType) {
@@ -0,0 +1,189 @@
+#include "rmb/pathfinding/NavGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include <frc/Filesystem.h>
+
+#include <units/math.h>
+
+#include <wpi/json.h>
+
+namespace rmb {
+
+namespace {
+
+/**
+ * One dimensional squared Euclidean distance transform (Felzenszwalb and
+ * Huttenlocher). Replaces every `count` values spaced `stride` apart starting
+ * at `values` with the lower envelope of the parabolas rooted at each of
+ * them. The scratch vectors are only used to avoid allocating.
+ */
+void transformLine(double *values, int count, size_t stride,
+                   std::vector<double> &input, std::vector<int> &roots,
+                   std::vector<double> &bounds) {
+  for (int i = 0; i < count; i++) {
+    input[i] = values[i * stride];
+  }
+
+  auto intersect = [&input](int q, int root) {
+    return ((input[q] + q * q) - (input[root] + root * root)) /
+           (2.0 * (q - root));
+  };
+
+  // Find the parabolas forming the lower envelope and where each one takes
+  // over from the last.
+  int parabola = 0;
+  roots[0] = 0;
+  bounds[0] = -std::numeric_limits<double>::infinity();
+  bounds[1] = std::numeric_limits<double>::infinity();
+
+  for (int q = 1; q < count; q++) {
+    double intersection = intersect(q, roots[parabola]);
+    while (intersection <= bounds[parabola]) {
+      parabola--;
+      intersection = intersect(q, roots[parabola]);
+    }
+
+    parabola++;
+    roots[parabola] = q;
+    bounds[parabola] = intersection;
+    bounds[parabola + 1] = std::numeric_limits<double>::infinity();
+  }
+
+  parabola = 0;
+  for (int q = 0; q < count; q++) {
+    while (bounds[parabola + 1] < q) {
+      parabola++;
+    }
+    int root = roots[parabola];
+    values[q * stride] = (q - root) * (q - root) + input[root];
+  }
+}
+
+} // namespace
+
+NavGrid::NavGrid(units::meter_t nodeSize, int width, int height,
+                 std::vector<uint8_t> blocked)
+    : nodeSize(nodeSize), width(width), height(height),
+      staticBlocked(std::move(blocked)) {
+  staticBlocked.resize(static_cast<size_t>(width) * height, true);
+  updateObstacles();
+}
+
+std::optional<NavGrid> NavGrid::fromFile(const std::string &filename) {
+  std::ifstream file(filename);
+  if (!file) {
+    std::cout << "Error: could not open navgrid " << filename << std::endl;
+    return std::nullopt;
+  }
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+
+  try {
+    wpi::json json = wpi::json::parse(contents.str());
+
+    const wpi::json &grid = json.at("grid");
+    int height = static_cast<int>(grid.size());
+    int width = height > 0 ? static_cast<int>(grid.at(0).size()) : 0;
+
+    std::vector<uint8_t> blocked;
+    blocked.reserve(static_cast<size_t>(width) * height);
+
+    for (const wpi::json &row : grid) {
+      for (int x = 0; x < width; x++) {
+        blocked.push_back(row.at(x).get<bool>());
+      }
+    }
+
+    return NavGrid(units::meter_t(json.at("nodeSizeMeters").get<double>()),
+                   width, height, std::move(blocked));
+  } catch (const std::exception &exception) {
+    std::cout << "Error: could not parse navgrid " << filename << ": "
+              << exception.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+std::optional<NavGrid> NavGrid::fromDeployDirectory() {
+  return fromFile(frc::filesystem::GetDeployDirectory() +
+                  "/pathplanner/navgrid.json");
+}
+
+void NavGrid::setBlocked(const NavGridCell &cell, bool isBlocked) {
+  if (contains(cell)) {
+    staticBlocked[getIndex(cell)] = isBlocked;
+    updateObstacles();
+  }
+}
+
+void NavGrid::setDynamicObstacles(
+    const std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+        &obstacles) {
+  dynamicObstacles = obstacles;
+  updateObstacles();
+}
+
+NavGridCell NavGrid::getCell(const frc::Translation2d &position) const {
+  return NavGridCell{
+      static_cast<int>(std::floor((position.X() / nodeSize).value())),
+      static_cast<int>(std::floor((position.Y() / nodeSize).value()))};
+}
+
+frc::Translation2d NavGrid::getCenter(const NavGridCell &cell) const {
+  return frc::Translation2d((cell.x + 0.5) * nodeSize,
+                            (cell.y + 0.5) * nodeSize);
+}
+
+void NavGrid::updateObstacles() {
+  blocked = staticBlocked;
+
+  for (const auto &[a, b] : dynamicObstacles) {
+    NavGridCell low = getCell(frc::Translation2d(
+        units::math::min(a.X(), b.X()), units::math::min(a.Y(), b.Y())));
+    NavGridCell high = getCell(frc::Translation2d(
+        units::math::max(a.X(), b.X()), units::math::max(a.Y(), b.Y())));
+
+    for (int y = std::max(low.y, 0); y <= std::min(high.y, height - 1); y++) {
+      for (int x = std::max(low.x, 0); x <= std::min(high.x, width - 1); x++) {
+        blocked[getIndex({x, y})] = true;
+      }
+    }
+  }
+
+  // Exact Euclidean distance transform: squared distances are found along
+  // every column and then along every row, after which each cell holds the
+  // squared distance to the nearest obstacle.
+  constexpr double kFar = 1e12;
+
+  std::vector<double> squared(blocked.size());
+  for (size_t i = 0; i < blocked.size(); i++) {
+    squared[i] = blocked[i] ? 0.0 : kFar;
+  }
+
+  int longest = std::max(width, height);
+  std::vector<double> input(longest);
+  std::vector<int> roots(longest);
+  std::vector<double> bounds(longest + 1);
+
+  for (int x = 0; x < width; x++) {
+    transformLine(squared.data() + x, height, width, input, roots, bounds);
+  }
+  for (int y = 0; y < height; y++) {
+    transformLine(squared.data() + static_cast<size_t>(y) * width, width, 1,
+                  input, roots, bounds);
+  }
+
+  clearance.resize(blocked.size());
+  for (size_t i = 0; i < blocked.size(); i++) {
+    clearance[i] = static_cast<float>(std::sqrt(squared[i]));
+  }
+}
+
+} // namespace rmb
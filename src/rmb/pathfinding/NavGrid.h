@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <frc/geometry/Translation2d.h>
+
+#include "units/length.h"
+
+namespace rmb {
+
+/**
+ * Cell of a `NavGrid`, indexed from the field origin.
+ */
+struct NavGridCell {
+  int x = 0; /* <- Column, along the field's x axis. */
+  int y = 0; /* <- Row, along the field's y axis. */
+
+  bool operator==(const NavGridCell &) const = default;
+};
+
+/**
+ * Occupancy grid of the field in the format PathPlanner stores in
+ * `deploy/pathplanner/navgrid.json`.
+ *
+ * Cells are stored in a single contiguous array, row by row, so neighbouring
+ * cells along x are neighbours in memory.
+ *
+ * Alongside the obstacles the grid keeps a distance field holding each cell's
+ * distance to the nearest obstacle. It is rebuilt whenever the obstacles
+ * change, which takes well under a millisecond for a full field.
+ */
+class NavGrid {
+public:
+  /**
+   * Constructs a NavGrid.
+   *
+   * @param nodeSize Width and height of each cell.
+   * @param width    Number of cells along the field's x axis.
+   * @param height   Number of cells along the field's y axis.
+   * @param blocked  Whether each cell is an obstacle, row by row. Must have
+   *                 `width * height` entries.
+   */
+  NavGrid(units::meter_t nodeSize, int width, int height,
+          std::vector<uint8_t> blocked);
+
+  /**
+   * Reads a navgrid written by PathPlanner.
+   *
+   * @param filename Path of the navgrid JSON file.
+   *
+   * @return The grid, or nothing if the file could not be read or parsed.
+   */
+  static std::optional<NavGrid> fromFile(const std::string &filename);
+
+  /**
+   * Reads `pathplanner/navgrid.json` from the deploy directory.
+   */
+  static std::optional<NavGrid> fromDeployDirectory();
+
+  units::meter_t getNodeSize() const { return nodeSize; }
+
+  int getWidth() const { return width; }
+
+  int getHeight() const { return height; }
+
+  /**
+   * Returns the number of cells in the grid.
+   */
+  size_t size() const { return blocked.size(); }
+
+  /**
+   * Returns whether a cell lies within the grid.
+   */
+  bool contains(const NavGridCell &cell) const {
+    return cell.x >= 0 && cell.y >= 0 && cell.x < width && cell.y < height;
+  }
+
+  /**
+   * Returns whether a cell is an obstacle. Cells outside of the grid are.
+   */
+  bool isBlocked(const NavGridCell &cell) const {
+    return !contains(cell) || blocked[getIndex(cell)];
+  }
+
+  /**
+   * Marks a cell as a permanent obstacle or as free space and rebuilds the
+   * distance field.
+   */
+  void setBlocked(const NavGridCell &cell, bool isBlocked);
+
+  /**
+   * Replaces the dynamic obstacles on the field, such as other robots. Cells
+   * overlapping any of the boxes are blocked on top of the grid's permanent
+   * obstacles, and the distance field is rebuilt.
+   *
+   * @param obstacles Opposite corners of each obstacle's bounding box.
+   */
+  void setDynamicObstacles(
+      const std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+          &obstacles);
+
+  /**
+   * Returns the distance, in cells, from a cell's center to the center of the
+   * nearest obstacle. Zero for obstacles and cells outside of the grid.
+   */
+  float getClearance(const NavGridCell &cell) const {
+    return contains(cell) ? clearance[getIndex(cell)] : 0.0f;
+  }
+
+  /**
+   * Returns the position of a cell in the contiguous cell array.
+   */
+  size_t getIndex(const NavGridCell &cell) const {
+    return static_cast<size_t>(cell.y) * width + cell.x;
+  }
+
+  /**
+   * Returns the cell at a position in the contiguous cell array.
+   */
+  NavGridCell getCell(size_t index) const {
+    return NavGridCell{static_cast<int>(index % width),
+                       static_cast<int>(index / width)};
+  }
+
+  /**
+   * Returns the cell containing a point on the field. The point may be
+   * outside of the grid.
+   */
+  NavGridCell getCell(const frc::Translation2d &position) const;
+
+  /**
+   * Returns the point at the center of a cell.
+   */
+  frc::Translation2d getCenter(const NavGridCell &cell) const;
+
+private:
+  /**
+   * Recomputes `blocked` from the permanent and dynamic obstacles and rebuilds
+   * the distance field.
+   */
+  void updateObstacles();
+
+  units::meter_t nodeSize;
+  int width;
+  int height;
+
+  std::vector<uint8_t> staticBlocked;
+  std::vector<uint8_t> blocked;
+  std::vector<float> clearance;
+  std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+      dynamicObstacles;
+};
+} // namespace rmb
@@ -0,0 +1,307 @@
+#include "rmb/pathfinding/NavGridPathfinder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <utility>
+
+namespace rmb {
+
+namespace {
+
+constexpr float kDiagonalCost = std::numbers::sqrt2_v<float>;
+
+/**
+ * Distance (in cells) from an obstacle within which routes are penalized,
+ * and the cost added per cell of clearance below it.
+ */
+constexpr float kPreferredClearance = 2.0f;
+constexpr float kProximityWeight = 0.5f;
+
+/**
+ * Neighbour offsets, orthogonal first.
+ */
+constexpr int kNeighbourX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+constexpr int kNeighbourY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+/**
+ * Search state for every cell of a grid, reused between searches on the same
+ * thread. A cell's entries are only meaningful when its stamp matches the
+ * current search, so nothing has to be cleared between searches.
+ */
+struct SearchBuffers {
+  using QueueEntry = std::pair<float, uint32_t>;
+
+  std::vector<float> cost;
+  std::vector<uint32_t> parent;
+  std::vector<uint32_t> visited; /* <- Search that last reached each cell. */
+  std::vector<uint32_t> closed;  /* <- Search that last expanded each cell. */
+  std::vector<QueueEntry> open;
+  std::vector<uint32_t> frontier;
+  uint32_t search = 0;
+
+  /**
+   * Prepares the buffers for a new search over `size` cells.
+   */
+  void begin(size_t size) {
+    if (cost.size() < size) {
+      cost.resize(size);
+      parent.resize(size);
+      visited.resize(size, 0);
+      closed.resize(size, 0);
+    }
+
+    open.clear();
+    frontier.clear();
+
+    if (++search == 0) {
+      std::fill(visited.begin(), visited.end(), 0);
+      std::fill(closed.begin(), closed.end(), 0);
+      search = 1;
+    }
+  }
+};
+
+SearchBuffers &getSearchBuffers() {
+  thread_local SearchBuffers buffers;
+  return buffers;
+}
+
+} // namespace
+
+NavGridPathfinder::NavGridPathfinder(NavGrid grid) : grid(std::move(grid)) {
+  int width = this->grid.getWidth();
+  int height = this->grid.getHeight();
+
+  distances.resize(static_cast<size_t>(width) * height);
+  for (int dy = 0; dy < height; dy++) {
+    for (int dx = 0; dx < width; dx++) {
+      distances[static_cast<size_t>(dy) * width + dx] =
+          std::sqrt(static_cast<float>(dx * dx + dy * dy));
+    }
+  }
+}
+
+std::vector<frc::Translation2d>
+NavGridPathfinder::findPath(const frc::Translation2d &start,
+                            const frc::Translation2d &goal) const {
+  std::optional<NavGridCell> startCell =
+      getNearestFreeCell(grid.getCell(start));
+  std::optional<NavGridCell> goalCell = getNearestFreeCell(grid.getCell(goal));
+
+  if (!startCell || !goalCell) {
+    return {};
+  }
+
+  std::vector<NavGridCell> cells = search(*startCell, *goalCell);
+  if (cells.empty()) {
+    return {};
+  }
+
+  // Every cell Theta* returns is a corner of the route.
+  std::vector<frc::Translation2d> waypoints;
+  waypoints.reserve(cells.size() + 1);
+  waypoints.push_back(start);
+
+  for (size_t i = 1; i + 1 < cells.size(); i++) {
+    waypoints.push_back(grid.getCenter(cells[i]));
+  }
+
+  waypoints.push_back(goal);
+  return waypoints;
+}
+
+std::optional<NavGridCell>
+NavGridPathfinder::getNearestFreeCell(const NavGridCell &cell) const {
+  NavGridCell clamped{std::clamp(cell.x, 0, grid.getWidth() - 1),
+                      std::clamp(cell.y, 0, grid.getHeight() - 1)};
+
+  if (!grid.contains(clamped)) {
+    return std::nullopt;
+  }
+
+  if (!grid.isBlocked(clamped)) {
+    return clamped;
+  }
+
+  // Breadth first search outwards from the cell.
+  SearchBuffers &buffers = getSearchBuffers();
+  buffers.begin(grid.size());
+
+  uint32_t clampedIndex = grid.getIndex(clamped);
+  buffers.frontier.push_back(clampedIndex);
+  buffers.visited[clampedIndex] = buffers.search;
+
+  for (size_t i = 0; i < buffers.frontier.size(); i++) {
+    NavGridCell current = grid.getCell(buffers.frontier[i]);
+
+    if (!grid.isBlocked(current)) {
+      return current;
+    }
+
+    for (int j = 0; j < 4; j++) {
+      NavGridCell next{current.x + kNeighbourX[j], current.y + kNeighbourY[j]};
+      if (!grid.contains(next)) {
+        continue;
+      }
+
+      uint32_t nextIndex = grid.getIndex(next);
+      if (buffers.visited[nextIndex] != buffers.search) {
+        buffers.visited[nextIndex] = buffers.search;
+        buffers.frontier.push_back(nextIndex);
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::vector<NavGridCell>
+NavGridPathfinder::search(const NavGridCell &start,
+                          const NavGridCell &goal) const {
+  constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+
+  SearchBuffers &buffers = getSearchBuffers();
+  buffers.begin(grid.size());
+
+  auto &open = buffers.open;
+  auto compare = std::greater<SearchBuffers::QueueEntry>();
+
+  uint32_t startIndex = grid.getIndex(start);
+  uint32_t goalIndex = grid.getIndex(goal);
+
+  buffers.cost[startIndex] = 0.0f;
+  buffers.parent[startIndex] = kNoParent;
+  buffers.visited[startIndex] = buffers.search;
+  open.emplace_back(getDistance(start, goal), startIndex);
+
+  while (!open.empty()) {
+    std::pop_heap(open.begin(), open.end(), compare);
+    uint32_t index = open.back().second;
+    open.pop_back();
+
+    if (buffers.closed[index] == buffers.search) {
+      continue;
+    }
+    buffers.closed[index] = buffers.search;
+
+    if (index == goalIndex) {
+      break;
+    }
+
+    NavGridCell cell = grid.getCell(index);
+    uint32_t parentIndex = buffers.parent[index];
+    std::optional<NavGridCell> parent;
+    if (parentIndex != kNoParent) {
+      parent = grid.getCell(parentIndex);
+    }
+
+    for (int i = 0; i < 8; i++) {
+      NavGridCell next{cell.x + kNeighbourX[i], cell.y + kNeighbourY[i]};
+      if (grid.isBlocked(next)) {
+        continue;
+      }
+
+      // Do not cut the corners of obstacles when moving diagonally.
+      bool diagonal = i >= 4;
+      if (diagonal && (grid.isBlocked({next.x, cell.y}) ||
+                       grid.isBlocked({cell.x, next.y}))) {
+        continue;
+      }
+
+      uint32_t nextIndex = grid.getIndex(next);
+      if (buffers.closed[nextIndex] == buffers.search) {
+        continue;
+      }
+
+      // Connect straight to this cell's parent when nothing is in the way,
+      // otherwise step from this cell like A*.
+      float nextCost;
+      uint32_t nextParent;
+      if (parent && hasLineOfSight(*parent, next)) {
+        nextCost = buffers.cost[parentIndex] + getDistance(*parent, next);
+        nextParent = parentIndex;
+      } else {
+        nextCost = buffers.cost[index] + (diagonal ? kDiagonalCost : 1.0f);
+        nextParent = index;
+      }
+      nextCost += getProximityCost(next);
+
+      if (buffers.visited[nextIndex] != buffers.search ||
+          nextCost < buffers.cost[nextIndex]) {
+        buffers.visited[nextIndex] = buffers.search;
+        buffers.cost[nextIndex] = nextCost;
+        buffers.parent[nextIndex] = nextParent;
+
+        open.emplace_back(nextCost + getDistance(next, goal), nextIndex);
+        std::push_heap(open.begin(), open.end(), compare);
+      }
+    }
+  }
+
+  if (buffers.closed[goalIndex] != buffers.search) {
+    return {};
+  }
+
+  std::vector<NavGridCell> cells;
+  for (uint32_t index = goalIndex; index != kNoParent;
+       index = buffers.parent[index]) {
+    cells.push_back(grid.getCell(index));
+  }
+
+  std::reverse(cells.begin(), cells.end());
+  return cells;
+}
+
+bool NavGridPathfinder::hasLineOfSight(const NavGridCell &from,
+                                       const NavGridCell &to) const {
+  // Every cell the line crosses has its center within half a diagonal of the
+  // line, so the line is clear if no obstacle is that close to `from`.
+  if (grid.getClearance(from) >
+      getDistance(from, to) + kDiagonalCost / 2.0f) {
+    return true;
+  }
+
+  // Walk every cell the line crosses. Passing exactly through a corner needs
+  // both cells beside the corner to be free, just like a diagonal move.
+  int dx = std::abs(to.x - from.x);
+  int dy = std::abs(to.y - from.y);
+  int stepX = to.x > from.x ? 1 : -1;
+  int stepY = to.y > from.y ? 1 : -1;
+  int error = dx - dy;
+
+  NavGridCell cell = from;
+  while (cell != to) {
+    if (error > 0) {
+      cell.x += stepX;
+      error -= 2 * dy;
+    } else if (error < 0) {
+      cell.y += stepY;
+      error += 2 * dx;
+    } else {
+      if (grid.isBlocked({cell.x + stepX, cell.y}) ||
+          grid.isBlocked({cell.x, cell.y + stepY})) {
+        return false;
+      }
+      cell.x += stepX;
+      cell.y += stepY;
+      error += 2 * (dx - dy);
+    }
+
+    if (grid.isBlocked(cell)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+float NavGridPathfinder::getProximityCost(const NavGridCell &cell) const {
+  return kProximityWeight *
+         std::max(0.0f, kPreferredClearance - grid.getClearance(cell));
+}
+
+} // namespace rmb
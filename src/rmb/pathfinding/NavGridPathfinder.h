@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdlib>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <frc/geometry/Translation2d.h>
+
+#include "rmb/pathfinding/NavGrid.h"
+
+namespace rmb {
+
+/**
+ * Finds collision free routes across a `NavGrid` with Theta*, an A* variant
+ * that connects cells in straight lines whenever nothing is in the way, so
+ * routes come out as a few any-angle segments instead of a staircase of grid
+ * moves.
+ *
+ * Routes keep away from obstacles where they can by using the grid's
+ * distance field, which also lets most straight line checks finish without
+ * walking the line. Heuristic distances are looked up from a table built
+ * when the pathfinder is constructed, and each thread reuses its own search
+ * buffers, so a search does not allocate once the thread has run one.
+ *
+ * Searching does not modify the pathfinder, so one instance may be shared by
+ * several threads. Changing obstacles must not overlap a search.
+ */
+class NavGridPathfinder {
+public:
+  /**
+   * Constructs a NavGridPathfinder.
+   *
+   * @param grid The grid to search.
+   */
+  explicit NavGridPathfinder(NavGrid grid);
+
+  /**
+   * Finds a route between two points.
+   *
+   * A start or goal inside an obstacle is moved to the nearest free cell.
+   *
+   * @param start Where the route begins.
+   * @param goal  Where the route ends.
+   *
+   * @return Waypoints from `start` to `goal`, both included, where the route
+   *         changes direction. Empty if the goal cannot be reached.
+   */
+  std::vector<frc::Translation2d>
+  findPath(const frc::Translation2d &start,
+           const frc::Translation2d &goal) const;
+
+  /**
+   * Replaces the dynamic obstacles on the grid. Routes found afterwards avoid
+   * them.
+   *
+   * @param obstacles Opposite corners of each obstacle's bounding box.
+   */
+  void setDynamicObstacles(
+      const std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+          &obstacles) {
+    grid.setDynamicObstacles(obstacles);
+  }
+
+  const NavGrid &getGrid() const { return grid; }
+
+private:
+  /**
+   * Returns the free cell closest to `cell`, or nothing if every cell is
+   * blocked.
+   */
+  std::optional<NavGridCell> getNearestFreeCell(const NavGridCell &cell) const;
+
+  /**
+   * Returns the cells from `start` to `goal`, both included, or nothing if
+   * there is no route. Both cells must be free.
+   */
+  std::vector<NavGridCell> search(const NavGridCell &start,
+                                  const NavGridCell &goal) const;
+
+  /**
+   * Returns whether a straight line between the centers of two cells only
+   * crosses free cells.
+   */
+  bool hasLineOfSight(const NavGridCell &from, const NavGridCell &to) const;
+
+  /**
+   * Returns the straight line distance, in cells, between two cells.
+   */
+  float getDistance(const NavGridCell &a, const NavGridCell &b) const {
+    return distances[static_cast<size_t>(std::abs(a.y - b.y)) *
+                         grid.getWidth() +
+                     std::abs(a.x - b.x)];
+  }
+
+  /**
+   * Returns the extra cost of passing through a cell for being close to an
+   * obstacle.
+   */
+  float getProximityCost(const NavGridCell &cell) const;
+
+  NavGrid grid;
+
+  /**
+   * Straight line distance for every horizontal and vertical separation of
+   * two cells, row by row.
+   */
+  std::vector<float> distances;
+};
+} // namespace rmb
@@ -0,0 +1,201 @@
+#include "rmb/pathfinding/PathfindingService.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+#include <frc/geometry/Rotation2d.h>
+
+#include <pathplanner/lib/path/GoalEndState.h>
+
+namespace rmb {
+
+//-------------------
+// PathfindingHandle
+//-------------------
+
+PathfindingHandle::PathfindingHandle(
+    std::shared_future<Waypoints> waypoints, const frc::Pose2d &start,
+    const frc::Pose2d &target, const pathplanner::PathConstraints &constraints)
+    : waypoints(std::move(waypoints)), start(start), target(target),
+      constraints(constraints) {}
+
+bool PathfindingHandle::isReady() const {
+  return waypoints.valid() && waypoints.wait_for(std::chrono::seconds(0)) ==
+                                  std::future_status::ready;
+}
+
+std::shared_ptr<pathplanner::PathPlannerPath> PathfindingHandle::get() const {
+  if (!waypoints.valid()) {
+    return nullptr;
+  }
+
+  Waypoints interior = waypoints.get();
+  if (!interior) {
+    return nullptr;
+  }
+
+  std::vector<frc::Translation2d> points;
+  points.reserve(interior->size() + 2);
+  points.push_back(start.Translation());
+  points.insert(points.end(), interior->begin(), interior->end());
+  points.push_back(target.Translation());
+
+  // Point each pose along the route so the bezier curve follows it.
+  std::vector<frc::Pose2d> poses;
+  poses.reserve(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    frc::Translation2d direction = i + 1 < points.size()
+                                       ? points[i + 1] - points[i]
+                                       : points[i] - points[i - 1];
+    poses.emplace_back(points[i], direction.Angle());
+  }
+
+  auto path = std::make_shared<pathplanner::PathPlannerPath>(
+      pathplanner::PathPlannerPath::bezierFromPoses(poses), *constraints,
+      pathplanner::GoalEndState(0.0_mps, target.Rotation()));
+  path->preventFlipping = true;
+
+  return path;
+}
+
+//--------------------
+// PathfindingService
+//--------------------
+
+PathfindingService::PathfindingService(NavGrid grid,
+                                       pathplanner::PathConstraints constraints,
+                                       size_t cacheCapacity)
+    : pathfinder(std::move(grid)), constraints(constraints),
+      cacheCapacity(std::max<size_t>(cacheCapacity, 1)) {
+  worker = std::thread([this]() { runWorker(); });
+}
+
+PathfindingService::~PathfindingService() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  jobAvailable.notify_all();
+  worker.join();
+
+  for (Job &job : jobs) {
+    job.result.set_value(nullptr);
+  }
+}
+
+PathfindingHandle PathfindingService::request(const frc::Pose2d &start,
+                                              const frc::Pose2d &target) {
+  NavGridCell startCell = pathfinder.getGrid().getCell(start.Translation());
+
+  CacheKey key{startCell.x, startCell.y,
+               std::llround(target.X().value() * 1000.0),
+               std::llround(target.Y().value() * 1000.0),
+               std::llround(target.Rotation().Degrees().value() * 10.0)};
+
+  std::shared_future<PathfindingHandle::Waypoints> waypoints;
+  bool queued = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+      cacheOrder.splice(cacheOrder.begin(), cacheOrder, cached->second);
+      waypoints = cached->second->second;
+    } else {
+      Job &job = jobs.emplace_back(Job{startCell, target.Translation(), {}});
+      waypoints = job.result.get_future().share();
+      queued = true;
+
+      cacheOrder.emplace_front(key, waypoints);
+      cache.emplace(key, cacheOrder.begin());
+
+      // Handles already given out keep an evicted route alive.
+      if (cacheOrder.size() > cacheCapacity) {
+        cache.erase(cacheOrder.back().first);
+        cacheOrder.pop_back();
+      }
+    }
+  }
+
+  if (queued) {
+    cacheMisses.fetch_add(1, std::memory_order_relaxed);
+    jobAvailable.notify_one();
+  } else {
+    cacheHits.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return PathfindingHandle(std::move(waypoints), start, target, constraints);
+}
+
+void PathfindingService::clearCache() {
+  std::lock_guard<std::mutex> lock(mutex);
+  cache.clear();
+  cacheOrder.clear();
+}
+
+void PathfindingService::setDynamicObstacles(
+    std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+        obstacles) {
+  std::lock_guard<std::mutex> lock(mutex);
+  pendingObstacles = std::move(obstacles);
+  cache.clear();
+  cacheOrder.clear();
+}
+
+size_t PathfindingService::CacheKeyHash::operator()(const CacheKey &key) const {
+  size_t hash = std::hash<int64_t>()(key.startX);
+  for (int64_t value :
+       {int64_t(key.startY), key.targetX, key.targetY, key.targetRotation}) {
+    hash ^= std::hash<int64_t>()(value) + 0x9e3779b97f4a7c15 + (hash << 6) +
+            (hash >> 2);
+  }
+  return hash;
+}
+
+void PathfindingService::runWorker() {
+  while (true) {
+    Job job;
+    std::optional<
+        std::vector<std::pair<frc::Translation2d, frc::Translation2d>>>
+        obstacles;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+      if (stopping) {
+        return;
+      }
+
+      job = std::move(jobs.front());
+      jobs.pop_front();
+      obstacles = std::exchange(pendingObstacles, std::nullopt);
+    }
+
+    // Only this thread searches, so the grid can be changed between jobs.
+    if (obstacles) {
+      pathfinder.setDynamicObstacles(*obstacles);
+    }
+
+    // Plan from the center of the start cell so the route suits any start
+    // within it.
+    std::vector<frc::Translation2d> route = pathfinder.findPath(
+        pathfinder.getGrid().getCenter(job.startCell), job.target);
+
+    if (route.empty()) {
+      job.result.set_value(nullptr);
+      continue;
+    }
+
+    job.result.set_value(
+        std::make_shared<const std::vector<frc::Translation2d>>(
+            route.begin() + 1, route.end() - 1));
+  }
+}
+
+} // namespace rmb
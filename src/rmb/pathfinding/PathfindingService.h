@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+
+#include <pathplanner/lib/path/PathConstraints.h>
+#include <pathplanner/lib/path/PathPlannerPath.h>
+
+#include "rmb/pathfinding/NavGrid.h"
+#include "rmb/pathfinding/NavGridPathfinder.h"
+
+namespace rmb {
+
+/**
+ * Result of a `PathfindingService::request()` that can be polled until the
+ * route has been planned.
+ */
+class PathfindingHandle {
+public:
+  PathfindingHandle() = default;
+
+  /**
+   * Returns whether the route has been planned, so `get()` will not block.
+   */
+  bool isReady() const;
+
+  /**
+   * Returns the planned path, waiting for planning to finish if needed. The
+   * path starts exactly at the requested start and ends at the requested
+   * target.
+   *
+   * @return The path, or nullptr if the target cannot be reached.
+   */
+  std::shared_ptr<pathplanner::PathPlannerPath> get() const;
+
+private:
+  friend class PathfindingService;
+
+  using Waypoints = std::shared_ptr<const std::vector<frc::Translation2d>>;
+
+  PathfindingHandle(std::shared_future<Waypoints> waypoints,
+                    const frc::Pose2d &start, const frc::Pose2d &target,
+                    const pathplanner::PathConstraints &constraints);
+
+  /**
+   * Interior waypoints of the route, excluding the start and target. Null
+   * when the target cannot be reached.
+   */
+  std::shared_future<Waypoints> waypoints;
+
+  frc::Pose2d start;
+  frc::Pose2d target;
+  std::optional<pathplanner::PathConstraints> constraints;
+};
+
+/**
+ * Plans routes across the field on a worker thread so planning never runs in
+ * the robot loop, and remembers every route it has planned.
+ *
+ * Routes are cached by the navgrid cell the robot starts in and by the
+ * target pose, so requesting the same target again from roughly the same
+ * place (such as driving to a scoring position) is served instantly. Only the
+ * path's first and last points are adjusted to the exact request. Once the
+ * cache is full, the least recently requested route is forgotten.
+ *
+ * The service only depends on a `NavGrid`, so it can be run and timed
+ * offline without a robot.
+ */
+class PathfindingService {
+public:
+  PathfindingService(const PathfindingService &) = delete;
+  PathfindingService(PathfindingService &&) = delete;
+
+  /**
+   * Constructs a PathfindingService and starts its worker thread.
+   *
+   * @param grid          The field to plan across.
+   * @param constraints   Constraints given to every generated path.
+   * @param cacheCapacity Most routes remembered at once.
+   */
+  PathfindingService(NavGrid grid, pathplanner::PathConstraints constraints,
+                     size_t cacheCapacity = 256);
+
+  /**
+   * Stops the worker thread. Requests that have not been planned yet get no
+   * path.
+   */
+  ~PathfindingService();
+
+  /**
+   * Requests a route from `start` to `target`. This never waits for
+   * planning.
+   *
+   * @param start  Current pose of the robot.
+   * @param target Pose to drive to.
+   *
+   * @return A handle to poll for the path.
+   */
+  PathfindingHandle request(const frc::Pose2d &start,
+                            const frc::Pose2d &target);
+
+  /**
+   * Forgets every cached route. Requests already waiting are still planned.
+   */
+  void clearCache();
+
+  /**
+   * Replaces the dynamic obstacles on the field, such as other robots, and
+   * forgets every cached route. Requests that have not started planning yet
+   * avoid the new obstacles. This never waits for planning.
+   *
+   * @param obstacles Opposite corners of each obstacle's bounding box.
+   */
+  void setDynamicObstacles(
+      std::vector<std::pair<frc::Translation2d, frc::Translation2d>>
+          obstacles);
+
+  /**
+   * Returns the number of requests served from the cache, including those
+   * that joined a route still being planned.
+   */
+  size_t getCacheHits() const {
+    return cacheHits.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the number of requests that had to be planned.
+   */
+  size_t getCacheMisses() const {
+    return cacheMisses.load(std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * Start cell and target pose of a request. Targets are quantized to a
+   * millimeter and a tenth of a degree.
+   */
+  struct CacheKey {
+    int startX;
+    int startY;
+    int64_t targetX;
+    int64_t targetY;
+    int64_t targetRotation;
+
+    bool operator==(const CacheKey &) const = default;
+  };
+
+  struct CacheKeyHash {
+    size_t operator()(const CacheKey &key) const;
+  };
+
+  struct Job {
+    NavGridCell startCell;
+    frc::Translation2d target;
+    std::promise<PathfindingHandle::Waypoints> result;
+  };
+
+  void runWorker();
+
+  NavGridPathfinder pathfinder;
+  pathplanner::PathConstraints constraints;
+
+  std::mutex mutex;
+  std::condition_variable jobAvailable;
+  std::deque<Job> jobs;
+  using CacheEntry =
+      std::pair<CacheKey, std::shared_future<PathfindingHandle::Waypoints>>;
+
+  /**
+   * Cached routes, most recently requested first.
+   */
+  std::list<CacheEntry> cacheOrder;
+  std::unordered_map<CacheKey, std::list<CacheEntry>::iterator, CacheKeyHash>
+      cache;
+  size_t cacheCapacity;
+  std::optional<
+      std::vector<std::pair<frc::Translation2d, frc::Translation2d>>>
+      pendingObstacles;
+  bool stopping = false;
+
+  std::atomic<size_t> cacheHits = 0;
+  std::atomic<size_t> cacheMisses = 0;
+
+  std::thread worker;
+};
+} // namespace rmb
@@ -1,33 +1,41 @@
 #include "AHRS.h"
 #include "frc/SerialPort.h"
 #include "frc/geometry/Rotation2d.h"
+#include "units/constants.h"
 #include "units/velocity.h"
 #include <memory>
+#include <utility>
 #include <rmb/sensors/AHRS/AHRSGyro.h>
 
 namespace rmb {
 
-AHRSGyro::AHRSGyro(frc::SerialPort::Port port)
-    : gyro(std::make_unique<AHRS>(port)) {}
+AHRSGyro::AHRSGyro(frc::SerialPort::Port port,
+                   std::shared_ptr<DataLogRecorder> recorder)
+    : gyro(std::make_unique<AHRS>(port)),
+      headingLog(std::move(recorder), "ahrs/heading", "radians") {}
 
 units::turn_t AHRSGyro::AHRSGyro::getZRotation() const {
   return units::degree_t(-gyro->GetRotation2d().Degrees());
 }
 
-frc::Rotation2d AHRSGyro::getRotation() const { return gyro->GetRotation2d(); }
+frc::Rotation2d AHRSGyro::getRotation() const {
+  frc::Rotation2d rotation = gyro->GetRotation2d();
+  headingLog.record({rotation.Radians()()});
+  return rotation;
+}
 
 void AHRSGyro::resetZRotation() { gyro->ZeroYaw(); }
 
 units::meters_per_second_squared_t AHRSGyro::getXAcceleration() const {
-  return units::meters_per_second_squared_t(this->gyro->GetRawAccelX());
+  return units::constants::g * this->gyro->GetRawAccelX();
 }
 
 units::meters_per_second_squared_t AHRSGyro::getYAcceleration() const {
-  return units::meters_per_second_squared_t(this->gyro->GetRawAccelY());
+  return units::constants::g * this->gyro->GetRawAccelY();
 }
 
 units::meters_per_second_squared_t AHRSGyro::getZAcceleration() const {
-  return units::meters_per_second_squared_t(this->gyro->GetRawAccelZ());
+  return units::constants::g * this->gyro->GetRawAccelZ();
 }
 
 units::meters_per_second_t AHRSGyro::getXVelocity() const {
@@ -6,11 +6,19 @@
 #include "units/acceleration.h"
 #include <memory>
 #include <rmb/sensors/gyro.h>
+#include <rmb/util/DataLogRecorder.h>
 
 namespace rmb {
 class AHRSGyro : public Gyro {
 public:
-  AHRSGyro(frc::SerialPort::Port port);
+  /**
+   * Constructs an AHRSGyro.
+   *
+   * @param port     Serial port the NavX is connected to.
+   * @param recorder If set, every heading read is recorded.
+   */
+  AHRSGyro(frc::SerialPort::Port port,
+           std::shared_ptr<DataLogRecorder> recorder = nullptr);
 
   virtual ~AHRSGyro() = default;
 
@@ -28,5 +36,8 @@ public:
 
 private:
   std::unique_ptr<AHRS> gyro;
+
+  /** Heading in radians each time it is read. */
+  DataLogChannel headingLog;
 };
 } // namespace rmb
@@ -0,0 +1,43 @@
+#include "rmb/sensors/sim/SimGyro.h"
+
+namespace rmb {
+
+units::turn_t SimGyro::getZRotation() const {
+  // Clockwise positive, like AHRSGyro.
+  return -getRotation().Radians();
+}
+
+frc::Rotation2d SimGyro::getRotation() const {
+  return frc::Rotation2d(units::radian_t(
+      state.load().heading - zeroHeading.load(std::memory_order_relaxed)));
+}
+
+void SimGyro::resetZRotation() {
+  zeroHeading.store(state.load().heading, std::memory_order_relaxed);
+}
+
+units::meters_per_second_squared_t SimGyro::getXAcceleration() const {
+  return units::meters_per_second_squared_t(state.load().xAcceleration);
+}
+
+units::meters_per_second_squared_t SimGyro::getYAcceleration() const {
+  return units::meters_per_second_squared_t(state.load().yAcceleration);
+}
+
+units::meters_per_second_squared_t SimGyro::getZAcceleration() const {
+  return 0.0_mps_sq;
+}
+
+units::meters_per_second_t SimGyro::getXVelocity() const {
+  return units::meters_per_second_t(state.load().xVelocity);
+}
+
+units::meters_per_second_t SimGyro::getYVelocity() const {
+  return units::meters_per_second_t(state.load().yVelocity);
+}
+
+units::meters_per_second_t SimGyro::getZVelocity() const {
+  return 0.0_mps;
+}
+
+} // namespace rmb
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+
+#include "frc/geometry/Rotation2d.h"
+
+#include "rmb/sensors/gyro.h"
+#include "rmb/util/SeqLock.h"
+
+namespace rmb {
+
+/**
+ * Simulated gyro reporting the motion given to it by a simulator, such as
+ * `SwerveDriveSim`.
+ */
+class SimGyro : public Gyro {
+public:
+  /**
+   * Motion of the robot. Accelerations and velocities are in the robot's
+   * frame. Accelerations are inertial, as an accelerometer reads them, not
+   * the rate of change of the robot relative velocity.
+   */
+  struct State {
+    double heading = 0.0; /* <- Radians, counterclockwise positive. */
+    double xAcceleration = 0.0, yAcceleration = 0.0;
+    double xVelocity = 0.0, yVelocity = 0.0;
+  };
+
+  SimGyro() = default;
+
+  /**
+   * Sets the motion the gyro reports. Call from the simulation thread only.
+   */
+  void setState(const State &state) { this->state.store(state); }
+
+  units::turn_t getZRotation() const override;
+  frc::Rotation2d getRotation() const override;
+  void resetZRotation() override;
+
+  units::meters_per_second_squared_t getXAcceleration() const override;
+  units::meters_per_second_squared_t getYAcceleration() const override;
+  units::meters_per_second_squared_t getZAcceleration() const override;
+
+  units::meters_per_second_t getXVelocity() const override;
+  units::meters_per_second_t getYVelocity() const override;
+  units::meters_per_second_t getZVelocity() const override;
+
+private:
+  SeqLock<State> state;
+
+  /** Heading reported as zero, set by `resetZRotation()`. */
+  std::atomic<double> zeroHeading = 0.0;
+};
+} // namespace rmb
@@ -0,0 +1,116 @@
+#include "rmb/util/DataLogRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <wpi/timestamp.h>
+
+namespace rmb {
+
+namespace {
+
+std::atomic<uint64_t> nextRecorderId = 1;
+
+} // namespace
+
+DataLogRecorder::DataLogRecorder(wpi::log::DataLog &log,
+                                 units::second_t writePeriod)
+    : log(log), writePeriod(writePeriod),
+      id(nextRecorderId.fetch_add(1, std::memory_order_relaxed)) {
+  writer = std::thread([this]() { runWriter(); });
+}
+
+DataLogRecorder::~DataLogRecorder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  stopRequested.notify_all();
+  writer.join();
+}
+
+DataLogRecorder::Channel
+DataLogRecorder::addChannel(std::string_view name, std::string_view metadata) {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.emplace_back(log, name, metadata);
+  return static_cast<Channel>(entries.size() - 1);
+}
+
+bool DataLogRecorder::record(Channel channel, std::span<const double> values) {
+  return record(channel, values, units::microsecond_t(wpi::Now()));
+}
+
+bool DataLogRecorder::record(Channel channel, std::span<const double> values,
+                             units::second_t timestamp) {
+  Record record;
+  record.channel = channel;
+  record.count = static_cast<uint32_t>(std::min(values.size(), kMaxValues));
+  record.timestamp = static_cast<int64_t>(units::microsecond_t(timestamp)());
+  std::copy_n(values.begin(), record.count, record.values.begin());
+
+  if (!getRing().push(record)) {
+    droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+DataLogRecorder::Ring &DataLogRecorder::getRing() {
+  // Each thread remembers its ring in every recorder it has recorded to.
+  // Recorder ids are never reused, so entries left by destroyed recorders
+  // are never matched.
+  thread_local std::vector<std::pair<uint64_t, Ring *>> threadRings;
+
+  for (const auto &[recorderId, ring] : threadRings) {
+    if (recorderId == id) {
+      return *ring;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  Ring *ring = rings.emplace_back(std::make_unique<Ring>()).get();
+  threadRings.emplace_back(id, ring);
+  return *ring;
+}
+
+void DataLogRecorder::drain() {
+  Record record;
+  for (const std::unique_ptr<Ring> &ring : rings) {
+    while (ring->pop(record)) {
+      if (record.channel < entries.size()) {
+        entries[record.channel].Append(
+            std::span<const double>(record.values.data(), record.count),
+            record.timestamp);
+      }
+    }
+  }
+}
+
+void DataLogRecorder::runWriter() {
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (!stopping) {
+    stopRequested.wait_for(
+        lock, std::chrono::duration<double>(writePeriod.value()),
+        [this]() { return stopping; });
+    drain();
+  }
+}
+
+//----------------
+// DataLogChannel
+//----------------
+
+DataLogChannel::DataLogChannel(std::shared_ptr<DataLogRecorder> recorder,
+                               std::string_view name,
+                               std::string_view metadata)
+    : recorder(std::move(recorder)) {
+  if (this->recorder) {
+    channel = this->recorder->addChannel(name, metadata);
+  }
+}
+
+} // namespace rmb
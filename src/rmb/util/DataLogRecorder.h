@@ -0,0 +1,205 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <frc/DataLogManager.h>
+
+#include <wpi/DataLog.h>
+
+#include "units/time.h"
+
+#include "rmb/util/SPSCQueue.h"
+
+namespace rmb {
+
+/**
+ * Records signals at full rate into a WPILib DataLog without slowing down the
+ * threads producing them.
+ *
+ * Each producing thread gets its own lock-free ring of fixed-size records the
+ * first time it records, so recording is a bounded copy into memory the
+ * thread owns: it never locks, allocates or makes a syscall. A background
+ * thread wakes periodically, drains every ring and appends the records to
+ * the log in batches. Records that do not fit because the writer fell behind
+ * are dropped and counted rather than blocking the producer.
+ */
+class DataLogRecorder {
+public:
+  /** Identifies a signal added with `addChannel()`. */
+  using Channel = uint32_t;
+
+  /** Most values a single record can hold. */
+  static constexpr size_t kMaxValues = 16;
+
+  /** Number of records each producing thread can buffer. */
+  static constexpr size_t kRingCapacity = 1024;
+
+  DataLogRecorder(const DataLogRecorder &) = delete;
+  DataLogRecorder(DataLogRecorder &&) = delete;
+
+  /**
+   * Constructs a DataLogRecorder and starts its writer thread.
+   *
+   * @param log         Log to write to. Defaults to the log started by
+   *                    `frc::DataLogManager`.
+   * @param writePeriod Time between batches written by the writer thread.
+   */
+  explicit DataLogRecorder(
+      wpi::log::DataLog &log = frc::DataLogManager::GetLog(),
+      units::second_t writePeriod = 0.02_s);
+
+  /**
+   * Stops the writer thread after writing everything recorded so far.
+   */
+  ~DataLogRecorder();
+
+  /**
+   * Adds a signal to the log as a double array entry. This allocates, so call
+   * it during setup rather than from the control loop.
+   *
+   * @param name     Name of the log entry.
+   * @param metadata Metadata stored with the entry, such as the meaning of
+   *                 each value.
+   *
+   * @return The channel to record the signal on.
+   */
+  Channel addChannel(std::string_view name, std::string_view metadata = {});
+
+  /**
+   * Records values on a channel, timestamped now. Safe to call from any
+   * thread.
+   *
+   * @param channel A channel returned by `addChannel()`.
+   * @param values  Up to `kMaxValues` values. Extra values are ignored.
+   *
+   * @return false if the record was dropped because this thread's ring was
+   *         full.
+   */
+  bool record(Channel channel, std::span<const double> values);
+
+  /**
+   * Records values on a channel with an explicit timestamp. Safe to call from
+   * any thread.
+   *
+   * @param channel   A channel returned by `addChannel()`.
+   * @param values    Up to `kMaxValues` values. Extra values are ignored.
+   * @param timestamp FPGA time the values were measured.
+   *
+   * @return false if the record was dropped because this thread's ring was
+   *         full.
+   */
+  bool record(Channel channel, std::span<const double> values,
+              units::second_t timestamp);
+
+  /**
+   * Returns the number of records dropped because a ring was full.
+   */
+  size_t getDroppedRecords() const {
+    return droppedRecords.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Record {
+    Channel channel = 0;
+    uint32_t count = 0;
+    int64_t timestamp = 0; /* <- Microseconds, same epoch as wpi::Now(). */
+    std::array<double, kMaxValues> values{};
+  };
+
+  using Ring = SPSCQueue<Record, kRingCapacity>;
+
+  /**
+   * Returns the calling thread's ring, creating it on the thread's first
+   * record.
+   */
+  Ring &getRing();
+
+  /**
+   * Appends every waiting record to the log. Must be called with `mutex`
+   * held.
+   */
+  void drain();
+
+  void runWriter();
+
+  wpi::log::DataLog &log;
+  units::second_t writePeriod;
+
+  /** Distinguishes recorders in each thread's ring cache. Never reused. */
+  const uint64_t id;
+
+  /**
+   * Protects `entries` and `rings`. Producers only take it when their thread
+   * records for the first time.
+   */
+  std::mutex mutex;
+  std::vector<wpi::log::DoubleArrayLogEntry> entries;
+  std::vector<std::unique_ptr<Ring>> rings;
+
+  std::condition_variable stopRequested;
+  bool stopping = false;
+
+  std::atomic<size_t> droppedRecords = 0;
+
+  std::thread writer;
+};
+
+/**
+ * A signal recorded by a `DataLogRecorder`, or nothing when no recorder was
+ * given. Lets classes record unconditionally without checking whether
+ * logging is enabled.
+ */
+class DataLogChannel {
+public:
+  DataLogChannel() = default;
+
+  /**
+   * Adds a signal to a recorder.
+   *
+   * @param recorder The recorder, or nullptr to record nothing.
+   * @param name     Name of the log entry.
+   * @param metadata Metadata stored with the entry.
+   */
+  DataLogChannel(std::shared_ptr<DataLogRecorder> recorder,
+                 std::string_view name, std::string_view metadata = {});
+
+  /**
+   * Records values, timestamped now.
+   */
+  void record(std::span<const double> values) const {
+    if (recorder) {
+      recorder->record(channel, values);
+    }
+  }
+
+  void record(std::initializer_list<double> values) const {
+    record(std::span<const double>(values.begin(), values.size()));
+  }
+
+  /**
+   * Records values measured at `timestamp`.
+   */
+  void record(std::span<const double> values, units::second_t timestamp) const {
+    if (recorder) {
+      recorder->record(channel, values, timestamp);
+    }
+  }
+
+  explicit operator bool() const { return recorder != nullptr; }
+
+private:
+  std::shared_ptr<DataLogRecorder> recorder;
+  DataLogRecorder::Channel channel = 0;
+};
+} // namespace rmb
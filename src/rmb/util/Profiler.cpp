@@ -0,0 +1,365 @@
+#include "rmb/util/Profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <system_error>
+
+#include <frc/Filesystem.h>
+
+#include <networktables/NetworkTableInstance.h>
+
+namespace rmb {
+
+//-------------
+// ProfileZone
+//-------------
+
+void ProfileZone::record(std::chrono::nanoseconds duration) {
+  uint64_t nanoseconds = static_cast<uint64_t>(std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+      0));
+
+  buckets[getBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t max = maxNanoseconds.load(std::memory_order_relaxed);
+  while (nanoseconds > max &&
+         !maxNanoseconds.compare_exchange_weak(max, nanoseconds,
+                                               std::memory_order_relaxed)) {
+  }
+
+  uint64_t overrun = overrunNanoseconds.load(std::memory_order_relaxed);
+  if (overrun != 0 && nanoseconds > overrun) {
+    Profiler::getInstance().overrunDumpRequested.store(
+        true, std::memory_order_relaxed);
+  }
+}
+
+void ProfileZone::setOverrunThreshold(units::second_t threshold) {
+  overrunNanoseconds.store(
+      static_cast<uint64_t>(std::max(units::nanosecond_t(threshold)(), 0.0)),
+      std::memory_order_relaxed);
+}
+
+ProfileZone::Summary ProfileZone::takeSummary() {
+  std::array<uint32_t, kNumBuckets> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    counts[i] = buckets[i].exchange(0, std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  Summary summary;
+  summary.count = total;
+  summary.max =
+      maxNanoseconds.exchange(0, std::memory_order_relaxed) / 1000.0;
+
+  if (total == 0) {
+    return summary;
+  }
+
+  // Report the upper bound of the bucket holding each percentile, capped at
+  // the largest duration actually seen.
+  auto percentile = [&](double fraction) {
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      seen += counts[i];
+      if (seen >= target) {
+        return std::min(getBucketLimit(i) / 1000.0, summary.max);
+      }
+    }
+    return summary.max;
+  };
+
+  summary.p50 = percentile(0.5);
+  summary.p99 = percentile(0.99);
+  return summary;
+}
+
+size_t ProfileZone::getBucket(uint64_t nanoseconds) {
+  // Durations under four nanoseconds get a bucket each. Above that, the
+  // power of two picks a group of four buckets and the next two bits pick
+  // the bucket within it.
+  if (nanoseconds < 4) {
+    return nanoseconds;
+  }
+
+  size_t exponent = std::bit_width(nanoseconds) - 1;
+  size_t mantissa = (nanoseconds >> (exponent - 2)) & 3;
+  return std::min(exponent * 4 + mantissa, kNumBuckets - 1);
+}
+
+double ProfileZone::getBucketLimit(size_t bucket) {
+  if (bucket < 4) {
+    return bucket + 1.0;
+  }
+
+  size_t exponent = bucket / 4;
+  size_t mantissa = bucket % 4;
+  return std::ldexp(4.0 + mantissa + 1.0, static_cast<int>(exponent) - 2);
+}
+
+//--------------------
+// ScopedProfileTimer
+//--------------------
+
+ScopedProfileTimer::~ScopedProfileTimer() {
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  zone.record(end - start);
+
+  if (Profiler::isTracing()) {
+    Profiler::getInstance().recordTraceEvent(zone, start, end);
+  }
+}
+
+//----------
+// Profiler
+//----------
+
+Profiler &Profiler::getInstance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+ProfileZone &Profiler::getZone(std::string_view name) {
+  Profiler &profiler = getInstance();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+
+  for (const std::unique_ptr<ProfileZone> &zone : profiler.zones) {
+    if (zone->getName() == name) {
+      return *zone;
+    }
+  }
+
+  return *profiler.zones.emplace_back(
+      std::make_unique<ProfileZone>(std::string(name)));
+}
+
+void Profiler::startPublishing(units::second_t period) {
+#ifndef RMB_PROFILING
+  // Nothing is ever recorded, so there is nothing to publish.
+  return;
+#endif
+
+  stopPublishing();
+
+  Profiler &profiler = getInstance();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+
+  profiler.notifier.emplace([&profiler]() { profiler.publish(); });
+  profiler.notifier->SetName("rmb profiler");
+  profiler.notifier->StartPeriodic(period);
+}
+
+void Profiler::stopPublishing() {
+  Profiler &profiler = getInstance();
+
+  // Stop outside of the lock, since stopping waits for a running publish.
+  std::optional<frc::Notifier> notifier;
+  {
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    notifier.swap(profiler.notifier);
+  }
+}
+
+void Profiler::publish() {
+  if (overrunDumpRequested.exchange(false, std::memory_order_relaxed)) {
+    dumpOverrun();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Zones are created lazily the first time their code runs.
+  if (publishedZones.size() < zones.size()) {
+    std::shared_ptr<nt::NetworkTable> table =
+        nt::NetworkTableInstance::GetDefault().GetTable("profiling");
+
+    for (size_t i = publishedZones.size(); i < zones.size(); i++) {
+      publishedZones.push_back(
+          {zones[i].get(),
+           table->GetDoubleArrayTopic(zones[i]->getName()).Publish()});
+    }
+  }
+
+  for (PublishedZone &published : publishedZones) {
+    ProfileZone::Summary summary = published.zone->takeSummary();
+    published.publisher.Set(std::array<double, 4>{
+        static_cast<double>(summary.count), summary.p50, summary.p99,
+        summary.max});
+  }
+}
+
+//---------
+// Tracing
+//---------
+
+namespace {
+
+/**
+ * Returns a small number identifying the calling thread in traces.
+ */
+uint32_t getTraceThreadId() {
+  static std::atomic<uint32_t> nextThreadId = 1;
+  thread_local uint32_t threadId =
+      nextThreadId.fetch_add(1, std::memory_order_relaxed);
+  return threadId;
+}
+
+/**
+ * Writes a string as a JSON string literal.
+ */
+void writeJsonString(std::ostream &out, std::string_view string) {
+  out << '"';
+  for (char c : string) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+} // namespace
+
+void Profiler::startTracing() {
+#ifndef RMB_PROFILING
+  // Nothing is ever recorded, so do not allocate the buffer.
+  return;
+#endif
+
+  Profiler &profiler = getInstance();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+
+  if (!profiler.traceEvents) {
+    profiler.traceEvents =
+        std::make_unique<SeqLock<TraceEvent>[]>(kTraceCapacity);
+  }
+
+  // Publishes the buffer to the threads that see tracing enabled.
+  tracing.store(true, std::memory_order_release);
+}
+
+void Profiler::stopTracing() {
+  tracing.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::recordTraceEvent(const ProfileZone &zone,
+                                std::chrono::steady_clock::time_point start,
+                                std::chrono::steady_clock::time_point end) {
+  // Each event claims its own slot, so slots only have two writers when the
+  // ring wraps around during a single write. The event is dropped then,
+  // since the trace is a sample and the writer must not wait.
+  uint64_t index = nextTraceEvent.fetch_add(1, std::memory_order_relaxed);
+
+  TraceEvent event;
+  event.zone = &zone;
+  event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    start.time_since_epoch())
+                    .count();
+  event.duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
+  event.thread = getTraceThreadId();
+
+  traceEvents[index % kTraceCapacity].tryStore(event);
+}
+
+bool Profiler::dumpTrace(const std::string &filename) {
+  return getInstance().writeTrace(filename);
+}
+
+bool Profiler::writeTrace(const std::string &filename) {
+  // Copy out every event first so the file is written without racing the
+  // threads still recording.
+  std::vector<TraceEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!traceEvents) {
+      std::cout << "Error: no trace to dump, call startTracing() first"
+                << std::endl;
+      return false;
+    }
+
+    events.reserve(kTraceCapacity);
+    for (size_t i = 0; i < kTraceCapacity; i++) {
+      TraceEvent event = traceEvents[i].load();
+      if (event.zone) {
+        events.push_back(event);
+      }
+    }
+  }
+
+  std::sort(events.begin(), events.end(),
+            [](const TraceEvent &a, const TraceEvent &b) {
+              return a.start < b.start;
+            });
+
+  std::ofstream file(filename, std::ios::trunc);
+  if (!file) {
+    std::cout << "Error: failed to open trace file " << filename << std::endl;
+    return false;
+  }
+
+  // Complete ("X") events with times in microseconds from the first event.
+  int64_t origin = events.empty() ? 0 : events.front().start;
+
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); i++) {
+    const TraceEvent &event = events[i];
+
+    file << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+    writeJsonString(file, event.zone->getName());
+    file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+         << ",\"ts\":" << (event.start - origin) / 1000.0
+         << ",\"dur\":" << event.duration / 1000.0 << "}";
+  }
+  file << "\n]}\n";
+
+  if (!file) {
+    std::cout << "Error: failed to write trace file " << filename << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void Profiler::dumpTraceOnOverrun(std::string_view zone,
+                                  units::second_t threshold) {
+#ifndef RMB_PROFILING
+  return;
+#endif
+
+  startTracing();
+  getZone(zone).setOverrunThreshold(threshold);
+}
+
+void Profiler::dumpOverrun() {
+  if (overrunDumps >= kMaxOverrunDumps) {
+    return;
+  }
+
+  std::filesystem::path directory =
+      std::filesystem::path(frc::filesystem::GetOperatingDirectory()) /
+      "traces";
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  std::string filename =
+      (directory / ("overrun-" + std::to_string(overrunDumps) + ".json"))
+          .string();
+  if (writeTrace(filename)) {
+    std::cout << "Loop overrun, wrote trace to " << filename << std::endl;
+  }
+
+  overrunDumps++;
+}
+
+} // namespace rmb
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <frc/Notifier.h>
+
+#include <networktables/DoubleArrayTopic.h>
+
+#include "units/time.h"
+
+#include "rmb/util/SeqLock.h"
+
+/**
+ * Times the rest of the enclosing scope and records it in the zone called
+ * `name`, and in the trace while tracing is enabled. Compiles to nothing
+ * unless `RMB_PROFILING` is defined, which the build does when run with
+ * `-PrmbProfiling`.
+ */
+#ifdef RMB_PROFILING
+#define RMB_PROFILE_CONCAT_INNER(a, b) a##b
+#define RMB_PROFILE_CONCAT(a, b) RMB_PROFILE_CONCAT_INNER(a, b)
+#define RMB_PROFILE_ZONE(name)                                                 \
+  static ::rmb::ProfileZone &RMB_PROFILE_CONCAT(rmbProfileZone, __LINE__) =    \
+      ::rmb::Profiler::getZone(name);                                          \
+  ::rmb::ScopedProfileTimer RMB_PROFILE_CONCAT(rmbProfileTimer, __LINE__)(     \
+      RMB_PROFILE_CONCAT(rmbProfileZone, __LINE__))
+#else
+#define RMB_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
+
+namespace rmb {
+
+/**
+ * Latency histogram of one instrumented section of code.
+ *
+ * Durations are counted in fixed buckets, four per power of two nanoseconds,
+ * so recording is a couple of relaxed atomic increments from any thread and
+ * percentiles are accurate to within about 19%.
+ */
+class ProfileZone {
+public:
+  /** Number of buckets, enough for durations up to about half a minute. */
+  static constexpr size_t kNumBuckets = 144;
+
+  /**
+   * Percentiles of the durations recorded since the last `takeSummary()`.
+   * Durations are in microseconds.
+   */
+  struct Summary {
+    uint64_t count = 0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+  };
+
+  explicit ProfileZone(std::string name) : name(std::move(name)) {}
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone(ProfileZone &&) = delete;
+
+  /**
+   * Records one duration. Safe to call from any thread.
+   */
+  void record(std::chrono::nanoseconds duration);
+
+  /**
+   * Returns the percentiles of everything recorded since the last call and
+   * resets the histogram.
+   */
+  Summary takeSummary();
+
+  const std::string &getName() const { return name; }
+
+  /**
+   * Requests a trace dump whenever a duration longer than `threshold` is
+   * recorded. Zero disables the check.
+   */
+  void setOverrunThreshold(units::second_t threshold);
+
+private:
+  /**
+   * Returns the bucket holding a duration in nanoseconds.
+   */
+  static size_t getBucket(uint64_t nanoseconds);
+
+  /**
+   * Returns the upper bound, in nanoseconds, of a bucket.
+   */
+  static double getBucketLimit(size_t bucket);
+
+  std::string name;
+  std::array<std::atomic<uint32_t>, kNumBuckets> buckets{};
+  std::atomic<uint64_t> maxNanoseconds = 0;
+  std::atomic<uint64_t> overrunNanoseconds = 0;
+};
+
+/**
+ * Records the time from its construction to its destruction in a zone. Use
+ * through `RMB_PROFILE_ZONE`.
+ */
+class ScopedProfileTimer {
+public:
+  explicit ScopedProfileTimer(ProfileZone &zone)
+      : zone(zone), start(std::chrono::steady_clock::now()) {}
+
+  ~ScopedProfileTimer();
+
+  ScopedProfileTimer(const ScopedProfileTimer &) = delete;
+  ScopedProfileTimer &operator=(const ScopedProfileTimer &) = delete;
+
+private:
+  ProfileZone &zone;
+  std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * Registry of every profile zone, publishing their histograms to
+ * NetworkTables and optionally recording a timeline of them that can be
+ * dumped as a Chrome trace.
+ */
+class Profiler {
+public:
+  /**
+   * Returns the zone with a name, creating it the first time. Zones are never
+   * destroyed, so the reference may be kept.
+   */
+  static ProfileZone &getZone(std::string_view name);
+
+  /**
+   * Starts publishing every zone periodically as a `profiling/<zone>` double
+   * array of the sample count, p50, p99 and max in microseconds over the
+   * last period. Does nothing when profiling is compiled out, so this can be
+   * called unconditionally.
+   *
+   * @param period Time between publishes.
+   */
+  static void startPublishing(units::second_t period = 1.0_s);
+
+  /**
+   * Stops publishing.
+   */
+  static void stopPublishing();
+
+  /** Number of events the trace holds before overwriting the oldest. */
+  static constexpr size_t kTraceCapacity = 1 << 15;
+
+  /**
+   * Starts recording the begin and end of every zone into a ring buffer of
+   * the last `kTraceCapacity` events, to be written out by `dumpTrace()`.
+   * Does nothing when profiling is compiled out.
+   */
+  static void startTracing();
+
+  /**
+   * Stops recording the trace. Events already recorded are kept.
+   */
+  static void stopTracing();
+
+  static bool isTracing() {
+    return tracing.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Writes the recorded trace as a Chrome trace JSON file, which can be
+   * opened with chrome://tracing or https://ui.perfetto.dev.
+   *
+   * @param filename File to write.
+   *
+   * @return false if the file could not be written.
+   */
+  static bool dumpTrace(const std::string &filename);
+
+  /**
+   * Starts tracing and dumps the trace whenever a zone takes longer than
+   * `threshold`. Dumps are written by the publishing thread, so
+   * `startPublishing()` must also be called. Files are written to
+   * `traces/overrun-<n>.json` in the operating directory, which is the
+   * project directory in simulation. Does nothing when profiling is
+   * compiled out.
+   *
+   * @param zone      Name of the zone to watch, such as
+   *                  `"Robot::TeleopPeriodic"`.
+   * @param threshold Longest acceptable duration of the zone.
+   */
+  static void dumpTraceOnOverrun(std::string_view zone,
+                                 units::second_t threshold);
+
+  /** Most overrun dumps written in one run, to bound disk usage. */
+  static constexpr int kMaxOverrunDumps = 8;
+
+private:
+  friend class ProfileZone;
+  friend class ScopedProfileTimer;
+
+  struct PublishedZone {
+    ProfileZone *zone;
+    nt::DoubleArrayPublisher publisher;
+  };
+
+  /** One timed zone in the trace. */
+  struct TraceEvent {
+    const ProfileZone *zone = nullptr; /* <- nullptr until first written. */
+    int64_t start = 0;    /* <- Nanoseconds on the steady clock. */
+    int64_t duration = 0; /* <- Nanoseconds. */
+    uint32_t thread = 0;
+  };
+
+  static Profiler &getInstance();
+
+  void publish();
+
+  void recordTraceEvent(const ProfileZone &zone,
+                        std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end);
+
+  bool writeTrace(const std::string &filename);
+
+  void dumpOverrun();
+
+  static inline std::atomic<bool> tracing = false;
+
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ProfileZone>> zones;
+  std::vector<PublishedZone> publishedZones;
+  std::optional<frc::Notifier> notifier;
+
+  /** Allocated the first time tracing starts and kept until exit. */
+  std::unique_ptr<SeqLock<TraceEvent>[]> traceEvents;
+  std::atomic<uint64_t> nextTraceEvent = 0;
+
+  std::atomic<bool> overrunDumpRequested = false;
+  int overrunDumps = 0;
+};
+} // namespace rmb
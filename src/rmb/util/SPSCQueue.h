@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace rmb {
+
+/**
+ * Bounded, lock-free queue for passing values from exactly one producer
+ * thread to exactly one consumer thread.
+ *
+ * Neither `push` nor `pop` ever blocks or allocates, which makes this
+ * suitable for handing data from a sensor or NetworkTables thread to the main
+ * robot loop. When the queue is full `push` fails rather than overwriting
+ * data the consumer has not read yet.
+ *
+ * @tparam T        Type of value stored. Must be copy assignable.
+ * @tparam Capacity Maximum number of values held. Must be a power of two.
+ */
+template <typename T, size_t Capacity> class SPSCQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SPSCQueue capacity must be a power of two");
+
+public:
+  SPSCQueue() = default;
+  SPSCQueue(const SPSCQueue &) = delete;
+  SPSCQueue(SPSCQueue &&) = delete;
+
+  /**
+   * Adds a value to the back of the queue. Must only be called from the
+   * producer thread.
+   *
+   * @param value The value to add.
+   *
+   * @return false if the queue was full and the value was not added.
+   */
+  bool push(const T &value) {
+    const size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail - head.load(std::memory_order_acquire) >= Capacity) {
+      return false;
+    }
+
+    buffer[currentTail & (Capacity - 1)] = value;
+    tail.store(currentTail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes the value at the front of the queue. Must only be called from the
+   * consumer thread.
+   *
+   * @param value Set to the removed value when the queue was not empty.
+   *
+   * @return false if the queue was empty.
+   */
+  bool pop(T &value) {
+    const size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    value = buffer[currentHead & (Capacity - 1)];
+    head.store(currentHead + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Discards every value currently in the queue. Must only be called from the
+   * consumer thread.
+   */
+  void clear() {
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+  /**
+   * Returns the number of values in the queue. This is only a snapshot when
+   * the other thread is active.
+   */
+  size_t size() const {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Returns the maximum number of values the queue can hold.
+   */
+  static constexpr size_t capacity() { return Capacity; }
+
+private:
+  std::array<T, Capacity> buffer{};
+
+  /** Index of the next value to pop. Only written by the consumer. */
+  alignas(64) std::atomic<size_t> head{0};
+
+  /** Index of the next value to push. Only written by the producer. */
+  alignas(64) std::atomic<size_t> tail{0};
+};
+} // namespace rmb
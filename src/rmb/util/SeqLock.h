@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace rmb {
+
+/**
+ * Sequence lock for publishing a small value from one writer thread to any
+ * number of reader threads.
+ *
+ * The writer never waits and readers never take a mutex: a reader that
+ * overlaps a write simply copies the value again, so it always returns a
+ * consistent value even though it may retry. Writes are cheap enough that
+ * retries are rare in practice.
+ *
+ * @tparam T Type of value published. Must be trivially copyable and default
+ *           constructible.
+ */
+template <typename T> class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock values must be trivially copyable");
+
+public:
+  SeqLock() { store(T()); }
+
+  explicit SeqLock(const T &value) { store(value); }
+
+  SeqLock(const SeqLock &) = delete;
+  SeqLock(SeqLock &&) = delete;
+
+  /**
+   * Publishes a new value. Only one thread may call this at a time.
+   *
+   * @param value The value to publish.
+   */
+  void store(const T &value) {
+    std::array<uint64_t, numWords> raw{};
+    std::memcpy(raw.data(), &value, sizeof(T));
+
+    const uint64_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < numWords; i++) {
+      words[i].store(raw[i], std::memory_order_relaxed);
+    }
+
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   * Publishes a new value unless another write is in progress. Unlike
+   * `store()`, this may be called from several threads at once: the
+   * thread that loses the race drops its value rather than interleaving
+   * with the other write.
+   *
+   * @param value The value to publish.
+   *
+   * @return false if the value was dropped.
+   */
+  bool tryStore(const T &value) {
+    std::array<uint64_t, numWords> raw{};
+    std::memcpy(raw.data(), &value, sizeof(T));
+
+    uint64_t seq = sequence.load(std::memory_order_relaxed);
+    if ((seq & 1) != 0 ||
+        !sequence.compare_exchange_strong(seq, seq + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < numWords; i++) {
+      words[i].store(raw[i], std::memory_order_relaxed);
+    }
+
+    sequence.store(seq + 2, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Returns the most recently published value. Safe to call from any thread.
+   */
+  T load() const {
+    std::array<uint64_t, numWords> raw;
+    uint64_t before, after;
+
+    do {
+      before = sequence.load(std::memory_order_acquire);
+      for (size_t i = 0; i < numWords; i++) {
+        raw[i] = words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1) != 0);
+
+    T value;
+    std::memcpy(&value, raw.data(), sizeof(T));
+    return value;
+  }
+
+private:
+  static constexpr size_t numWords = (sizeof(T) + 7) / 8;
+
+  /** Odd while a write is in progress. */
+  std::atomic<uint64_t> sequence{0};
+
+  std::array<std::atomic<uint64_t>, numWords> words{};
+};
+} // namespace rmb
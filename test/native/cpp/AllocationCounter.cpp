@@ -0,0 +1,50 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local bool countAllocations = false;
+thread_local size_t allocations = 0;
+} // namespace
+
+void *operator new(size_t size) {
+  if (countAllocations) {
+    allocations++;
+  }
+
+  if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  if (countAllocations) {
+    allocations++;
+  }
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+  std::free(pointer);
+}
+
+namespace rmb {
+
+ScopedAllocationCounter::ScopedAllocationCounter()
+    : start(allocations), wasCounting(countAllocations) {
+  countAllocations = true;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter() {
+  countAllocations = wasCounting;
+}
+
+size_t ScopedAllocationCounter::count() const { return allocations - start; }
+
+} // namespace rmb
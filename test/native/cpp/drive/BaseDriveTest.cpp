@@ -0,0 +1,188 @@
+#include <array>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <networktables/DoubleArrayTopic.h>
+#include <networktables/NetworkTableInstance.h>
+#include <networktables/NetworkTableValue.h>
+
+#include <frc2/command/Commands.h>
+
+#include "units/time.h"
+
+#include "AllocationCounter.h"
+#include "rmb/drive/BaseDrive.h"
+
+namespace {
+
+/**
+ * Drive that does nothing but listen for vision, so the vision path can be
+ * tested without any motors.
+ */
+class VisionOnlyDrive : public rmb::BaseDrive {
+public:
+  VisionOnlyDrive(const std::vector<std::string> &cameraTables,
+                  nt::NetworkTableInstance ntInstance)
+      : BaseDrive(cameraTables, ntInstance) {}
+
+  using BaseDrive::handleVisionEvent;
+  using BaseDrive::takeVisionMeasurements;
+
+  void driveChassisSpeeds(frc::ChassisSpeeds) override {}
+  frc::ChassisSpeeds getChassisSpeeds() const override { return {}; }
+
+  frc::Pose2d getPose() const override { return {}; }
+  frc::Pose2d updatePose() override { return {}; }
+  void addVisionMeasurments(const frc::Pose2d &, units::second_t) override {}
+  void setVisionSTDevs(wpi::array<double, 3>) override {}
+  void resetPose(const frc::Pose2d &) override {}
+
+  bool isHolonomic() const override { return true; }
+
+  frc2::CommandPtr
+  followWPILibTrajectory(frc::Trajectory,
+                         std::initializer_list<frc2::Subsystem *>) override {
+    return frc2::cmd::None();
+  }
+
+  frc2::CommandPtr
+  followPPPath(std::shared_ptr<pathplanner::PathPlannerPath>,
+               std::initializer_list<frc2::Subsystem *>) override {
+    return frc2::cmd::None();
+  }
+};
+
+class BaseDriveVisionTest : public ::testing::Test {
+protected:
+  void SetUp() override { ntInstance = nt::NetworkTableInstance::Create(); }
+
+  void TearDown() override { nt::NetworkTableInstance::Destroy(ntInstance); }
+
+  nt::NetworkTableInstance ntInstance;
+};
+
+constexpr std::array<double, rmb::BaseDrive::kVisionRecordSize> kRecord = {
+    1.0, 2.0, 0.5, 3.25, 2.0, 0.1, 0.2, 0.3, 0.4, 1.5};
+
+} // namespace
+
+TEST(BaseDriveTest, ParseVisionRecord) {
+  std::optional<rmb::VisionMeasurement> measurement =
+      rmb::BaseDrive::parseVisionRecord(kRecord, 10_s, 1);
+  ASSERT_TRUE(measurement);
+
+  EXPECT_DOUBLE_EQ(1.0, measurement->pose.X().value());
+  EXPECT_DOUBLE_EQ(2.0, measurement->pose.Y().value());
+  EXPECT_DOUBLE_EQ(0.5, measurement->pose.Rotation().Radians().value());
+  EXPECT_DOUBLE_EQ(3.25, measurement->timestamp.value());
+  EXPECT_EQ(2, measurement->tagCount);
+  EXPECT_DOUBLE_EQ(0.1, measurement->ambiguity);
+  ASSERT_TRUE(measurement->stdDevs);
+  EXPECT_DOUBLE_EQ(0.3, (*measurement->stdDevs)[1]);
+  EXPECT_DOUBLE_EQ(1.5, measurement->tagDistance.value());
+  EXPECT_EQ(1u, measurement->camera);
+}
+
+TEST(BaseDriveTest, ParseVisionRecordDefaults) {
+  // Old nine entry record with no capture time or standard deviations.
+  std::array<double, rmb::BaseDrive::kVisionRecordSize - 1> record = {
+      1.0, 2.0, 0.5, 0.0, 1.0, 0.1, 0.0, 0.0, 0.0};
+
+  std::optional<rmb::VisionMeasurement> measurement =
+      rmb::BaseDrive::parseVisionRecord(record, 10_s, 0);
+  ASSERT_TRUE(measurement);
+
+  EXPECT_DOUBLE_EQ(10.0, measurement->timestamp.value());
+  EXPECT_FALSE(measurement->stdDevs);
+  EXPECT_DOUBLE_EQ(0.0, measurement->tagDistance.value());
+}
+
+TEST(BaseDriveTest, ParseVisionRecordRejectsMalformed) {
+  EXPECT_FALSE(rmb::BaseDrive::parseVisionRecord(
+      std::span<const double>(kRecord).first(5), 10_s, 0));
+  EXPECT_FALSE(rmb::BaseDrive::parseVisionRecord({}, 10_s, 0));
+}
+
+TEST(BaseDriveTest, ParseVisionRecordDoesNotAllocate) {
+  std::array<double, rmb::BaseDrive::kVisionRecordSize - 1> shortRecord = {};
+
+  size_t allocated;
+  {
+    rmb::ScopedAllocationCounter allocations;
+    for (int i = 0; i < 1000; i++) {
+      rmb::BaseDrive::parseVisionRecord(kRecord, 10_s, 0);
+      rmb::BaseDrive::parseVisionRecord(shortRecord, 10_s, 0);
+      rmb::BaseDrive::parseVisionRecord({}, 10_s, 0);
+    }
+    allocated = allocations.count();
+  }
+  EXPECT_EQ(0u, allocated);
+}
+
+TEST_F(BaseDriveVisionTest, TakeVisionMeasurementsInCaptureOrder) {
+  VisionOnlyDrive drive({"/cameras/front", "/cameras/back"}, ntInstance);
+  nt::DoubleArrayPublisher front = ntInstance.GetTable("/cameras/front")
+                                       ->GetDoubleArrayTopic("measurement")
+                                       .Publish();
+  nt::DoubleArrayPublisher back = ntInstance.GetTable("/cameras/back")
+                                      ->GetDoubleArrayTopic("measurement")
+                                      .Publish();
+
+  std::array<double, rmb::BaseDrive::kVisionRecordSize> record = kRecord;
+  record[3] = 5.0;
+  front.Set(record);
+  record[3] = 4.0;
+  back.Set(record);
+  ASSERT_TRUE(ntInstance.WaitForListenerQueue(1.0));
+
+  std::span<const rmb::VisionMeasurement> measurements =
+      drive.takeVisionMeasurements();
+  ASSERT_EQ(2u, measurements.size());
+  EXPECT_DOUBLE_EQ(4.0, measurements[0].timestamp.value());
+  EXPECT_EQ(1u, measurements[0].camera);
+  EXPECT_DOUBLE_EQ(5.0, measurements[1].timestamp.value());
+  EXPECT_EQ(0u, measurements[1].camera);
+
+  EXPECT_TRUE(drive.takeVisionMeasurements().empty());
+}
+
+TEST_F(BaseDriveVisionTest, VisionPathDoesNotAllocate) {
+  VisionOnlyDrive drive({"/cameras/front"}, ntInstance);
+
+  // The allocation counter only sees the calling thread, so the listener
+  // body is called here rather than on the NetworkTables thread. Nothing is
+  // published, so the listener never runs alongside it.
+  std::array<double, rmb::BaseDrive::kVisionRecordSize> record = kRecord;
+  for (int frame = 0; frame < 100; frame++) {
+    // Several frames per loop, as a camera faster than the robot sends.
+    // Building the events allocates, so it is done before counting.
+    std::vector<nt::Event> events;
+    for (int i = 0; i < 3; i++) {
+      record[3] = 3 * frame + i;
+      events.emplace_back(0, nt::EventFlags::kValueRemote,
+                          nt::ValueEventData(
+                              0, 0, nt::Value::MakeDoubleArray(record, 1000)));
+    }
+
+    size_t taken;
+    size_t allocated;
+    {
+      rmb::ScopedAllocationCounter allocations;
+      for (const nt::Event &event : events) {
+        drive.handleVisionEvent(event, 0);
+      }
+      taken = drive.takeVisionMeasurements().size();
+      allocated = allocations.count();
+    }
+    EXPECT_EQ(0u, allocated);
+    EXPECT_EQ(3u, taken);
+  }
+
+  EXPECT_EQ(0u, drive.getDroppedVisionMeasurements());
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+namespace rmb {
+
+/**
+ * Counts the heap allocations made by the current thread while it is alive.
+ * The test binary replaces the global `operator new` so every allocation is
+ * seen, including those made inside the standard library.
+ */
+class ScopedAllocationCounter {
+public:
+  ScopedAllocationCounter();
+  ~ScopedAllocationCounter();
+
+  ScopedAllocationCounter(const ScopedAllocationCounter &) = delete;
+  ScopedAllocationCounter &operator=(const ScopedAllocationCounter &) = delete;
+
+  /** Allocations made since construction. */
+  size_t count() const;
+
+private:
+  size_t start;
+  bool wasCounting;
+};
+
+} // namespace rmb
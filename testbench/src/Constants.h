@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <optional>
+#include <rmb/motorcontrol/Talon/StatusSignalRegistry.h>
 #include <rmb/motorcontrol/Talon/TalonFXPositionController.h>
 #include <rmb/motorcontrol/Talon/TalonFXVelocityController.h>
 
@@ -24,6 +26,10 @@ const units::meter_t wheelCircumference = 1.0_m;
 
 const frc::SerialPort::Port gyroPort = frc::SerialPort::Port::kMXP;
 
+// Shared by every drive motor so their signals are refreshed together.
+inline const std::shared_ptr<rmb::StatusSignalRegistry> signalRegistry =
+    std::make_shared<rmb::StatusSignalRegistry>();
+
 const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo{
     .config = {.id = 10, .inverted = false, .brake = true},
     .pidConfig = velocityModulePIDConfig,
@@ -34,6 +40,7 @@ const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo{
     .openLoopConfig = {.minOutput = -1.0, .maxOutput = 1.0, .rampRate = 0.0_s},
     .currentLimits = {},
     .canCoderConfig = std::nullopt,
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo{
@@ -55,6 +62,7 @@ const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo{
             .id = 11,
             .magnetOffset = module1Zero,
         },
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo1{
@@ -67,6 +75,7 @@ const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo1{
     .openLoopConfig = {.minOutput = -1.0, .maxOutput = 1.0, .rampRate = 0.0_s},
     .currentLimits = {},
     .canCoderConfig = std::nullopt,
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo1{
@@ -88,6 +97,7 @@ const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo1{
             .id = 21,
             .magnetOffset = module2Zero,
         },
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo2{
@@ -100,6 +110,7 @@ const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo2{
     .openLoopConfig = {.minOutput = -1.0, .maxOutput = 1.0, .rampRate = 0.0_s},
     .currentLimits = {},
     .canCoderConfig = std::nullopt,
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo2{
@@ -121,6 +132,7 @@ const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo2{
             .id = 31,
             .magnetOffset = module3Zero,
         },
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo3{
@@ -133,6 +145,7 @@ const rmb::TalonFXVelocityController::CreateInfo velocityControllerCreateInfo3{
     .openLoopConfig = {.minOutput = -1.0, .maxOutput = 1.0, .rampRate = 0.0_s},
     .currentLimits = {},
     .canCoderConfig = std::nullopt,
+    .signalRegistry = signalRegistry,
 };
 
 const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo3{
@@ -154,6 +167,7 @@ const rmb::TalonFXPositionController::CreateInfo positionControllerCreateInfo3{
             .id = 41,
             .magnetOffset = module4Zero,
         },
+    .signalRegistry = signalRegistry,
 };
 
 } // namespace constants
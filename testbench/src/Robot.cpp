@@ -6,14 +6,18 @@
 #include "frc/controller/HolonomicDriveController.h"
 #include "frc/controller/ProfiledPIDController.h"
 #include "frc/smartdashboard/SmartDashboard.h"
+#include "rmb/drive/PathCache.h"
+#include "rmb/drive/SampledTrajectory.h"
 #include "rmb/drive/SwerveDrive.h"
 #include "rmb/drive/SwerveModule.h"
 #include "rmb/motorcontrol/AngularVelocityController.h"
 #include "rmb/motorcontrol/Talon/TalonFXPositionController.h"
 #include "rmb/motorcontrol/Talon/TalonFXVelocityController.h"
+#include "rmb/util/Profiler.h"
 #include "units/angle.h"
 
 #include <frc2/command/CommandScheduler.h>
+#include <frc2/command/Commands.h>
 #include <memory>
 
 #include "Constants.h"
@@ -64,12 +68,31 @@ void Robot::RobotInit() {
                   6.28_rad_per_s, 3.14_rad_per_s / 1_s))),
       7.0_mps);
 
+  // Trajectories are pre-generated by the generateTrajectories Gradle task
+  // on deploy. Paths without one are generated by the cache.
+  pathCache = std::make_unique<rmb::PathCache>();
+
   frc::SmartDashboard::PutNumber("joyX", 0.0);
   frc::SmartDashboard::PutNumber("joyY", 0.0);
   frc::SmartDashboard::PutNumber("joyTwist", 0.0);
+
+  rmb::Profiler::startPublishing();
+  rmb::Profiler::dumpTraceOnOverrun("Robot::RobotPeriodic", 40_ms);
 }
 
-void Robot::RobotPeriodic() { frc2::CommandScheduler::GetInstance().Run(); }
+void Robot::RobotPeriodic() {
+  RMB_PROFILE_ZONE("Robot::RobotPeriodic");
+
+  // Read the sensors once before any command drives or follows a path.
+  constants::signalRegistry->refreshAll();
+  swerveDrive->sample();
+  swerveDrive->updatePose();
+
+  {
+    RMB_PROFILE_ZONE("CommandScheduler::Run");
+    frc2::CommandScheduler::GetInstance().Run();
+  }
+}
 
 void Robot::DisabledInit() {}
 
@@ -77,28 +100,45 @@ void Robot::DisabledPeriodic() {}
 
 void Robot::DisabledExit() {}
 
-void Robot::AutonomousInit() {}
+void Robot::AutonomousInit() {
+  // Usually already loaded in the background since RobotInit(), from the
+  // file pre-generated in simulation.
+  std::shared_ptr<const rmb::SampledTrajectory> trajectory =
+      pathCache->getTrajectory("bruhPath");
+
+  if (trajectory) {
+    swerveDrive->resetPose(trajectory->getInitialPose());
+    m_autonomousCommand =
+        swerveDrive->followSampledTrajectory(trajectory, {&driveSubsystem});
+    m_autonomousCommand->Schedule();
+  }
+}
 
 void Robot::AutonomousPeriodic() {}
 
 void Robot::AutonomousExit() {}
 
-void Robot::TeleopInit() { gyro->resetZRotation(); }
+void Robot::TeleopInit() {
+  gyro->resetZRotation();
+
+  if (m_autonomousCommand) {
+    m_autonomousCommand->Cancel();
+  }
+
+  teleopCommand =
+      frc2::cmd::Run([this]() { driveWithGamepad(); }, {&driveSubsystem});
+  teleopCommand->Schedule();
+}
 
 inline static double ensureMagnitudeMax(double val, double mag) {
   return wpi::sgn(val) * std::clamp(std::abs(val), 0.0, mag);
 }
 
-void Robot::TeleopPeriodic() {
-  // units::millisecond_t startTime = frc::Timer::GetFPGATimestamp();
-  // swerveDrive->driveCartesian(joystick.GetX() * (joystick.GetThrottle()),
-  //                             -joystick.GetY() * joystick.GetThrottle(),
-  //                             -joystick.GetTwist() * joystick.GetThrottle(),
-  //                             false);
+void Robot::TeleopPeriodic() {}
+
+void Robot::driveWithGamepad() {
+  RMB_PROFILE_ZONE("Robot::driveWithGamepad");
 
-  // std::cout << ((units::millisecond_t)frc::Timer::GetFPGATimestamp() -
-  //               startTime)()
-  //           << std::endl;
   const double maxOpenloop = 0.15;
 
   swerveDrive->driveCartesian(
@@ -111,7 +151,11 @@ void Robot::TeleopPeriodic() {
   swerveDrive->updateNTDebugInfo(true);
 }
 
-void Robot::TeleopExit() {}
+void Robot::TeleopExit() {
+  if (teleopCommand) {
+    teleopCommand->Cancel();
+  }
+}
 
 void Robot::TestInit() { frc2::CommandScheduler::GetInstance().CancelAll(); }
 
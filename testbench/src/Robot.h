@@ -8,6 +8,7 @@
 
 #include <frc/TimedRobot.h>
 #include <frc2/command/CommandPtr.h>
+#include <frc2/command/SubsystemBase.h>
 
 #include "Constants.h"
 #include "RobotContainer.h"
@@ -22,10 +23,17 @@
 #include <rmb/controller/LogitechGamepad.h>
 #include <rmb/controller/LogitechJoystick.h>
 
+#include <rmb/drive/PathCache.h>
 #include <rmb/drive/SwerveDrive.h>
 
 #include <AHRS.h>
 
+/**
+ * Requirement shared by every command that drives the swerve drive, so only
+ * one of them drives it at a time.
+ */
+class DriveSubsystem : public frc2::SubsystemBase {};
+
 class Robot : public frc::TimedRobot {
 public:
   Robot() : frc::TimedRobot(40_ms) {}
@@ -45,10 +53,21 @@ public:
   void TestExit() override;
 
 private:
+  /**
+   * Drives with the gamepad. Run from a command so it uses the snapshot
+   * sampled in `RobotPeriodic()` this loop.
+   */
+  void driveWithGamepad();
+
+  DriveSubsystem driveSubsystem;
+
   std::optional<frc2::CommandPtr> m_autonomousCommand;
+  std::optional<frc2::CommandPtr> teleopCommand;
 
   std::unique_ptr<rmb::SwerveDrive<4>> swerveDrive;
 
+  std::unique_ptr<rmb::PathCache> pathCache;
+
   // rmb::LogitechJoystick joystick = rmb::LogitechJoystick(0, 0.05);
   rmb::LogitechGamepad gamepad = rmb::LogitechGamepad(0, 0.05, false);
 
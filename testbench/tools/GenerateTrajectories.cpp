@@ -0,0 +1,20 @@
+#include <iostream>
+
+#include "rmb/drive/SampledTrajectory.h"
+
+/**
+ * Writes every PathPlanner path in src/main/deploy to a trajectory file so
+ * the robot does not have to generate them at runtime. Run from the project
+ * directory by the `generateTrajectories` task before each deploy.
+ */
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cout << "Usage: " << argv[0] << " <output directory>" << std::endl;
+    return 1;
+  }
+
+  size_t written = rmb::SampledTrajectory::pregeneratePathPlannerPaths(argv[1]);
+  std::cout << "Wrote " << written << " trajectories to " << argv[1]
+            << std::endl;
+  return 0;
+}